@@ -4,6 +4,8 @@
 #include <graphics/atlas.h>
 #include <graphics/font.h>
 #include <graphics/image.h>
+#include <graphics/render_target_pool.h>
+#include <graphics/texture_pages.h>
 #include <graphics/system.h>
 #include <graphics/texture_part.h>
 #include <graphics/tex_region.h>
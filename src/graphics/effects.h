@@ -4,6 +4,7 @@
 #include <glm/glm.hpp>
 #include <skygfx/skygfx.h>
 #include <skygfx/utils.h>
+#include <sky/renderer.h>
 
 namespace sky::effects
 {
@@ -27,6 +28,9 @@ namespace sky::effects
 	public:
 		Effect()
 		{
+			if (RENDERER->isHeadless())
+				return; // no device to compile shaders for
+
 			auto type_index = std::type_index(typeid(T));
 			auto& context = skygfx::utils::GetContext();
 
@@ -71,7 +75,7 @@ namespace sky::effects
 		T uniform;
 
 	private:
-		skygfx::Shader* mShader;
+		skygfx::Shader* mShader = nullptr;
 	};
 
 	struct alignas(16) Sdf
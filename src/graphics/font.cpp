@@ -1,139 +1,402 @@
 #include "font.h"
 
 #include <stb_truetype.h>
-#include <rectpack2D/finders_interface.h>
-#include <graphics/image.h>
-#include <vector>
+#include <sky/threadpool.h>
+#include <sky/locator.h>
+#include <sky/renderer.h>
+#include <common/helpers.h>
+#include <algorithm>
+#include <cstring>
 
 using namespace Graphics;
 
-Font::Font(void* data, size_t size) 
+static uint16_t ReadU16(const uint8_t* p)
 {
-	stbtt_fontinfo info;
-	stbtt_InitFont(&info, (uint8_t*)data, 0);
+	return static_cast<uint16_t>((p[0] << 8) | p[1]);
+}
+
+static int16_t ReadS16(const uint8_t* p)
+{
+	return static_cast<int16_t>(ReadU16(p));
+}
 
-	float scale = stbtt_ScaleForPixelHeight(&info, GlyphSize);
+static uint32_t MakeKerningKey(uint16_t left, uint16_t right)
+{
+	return (static_cast<uint32_t>(left) << 16) | right;
+}
 
-	struct glyph
+// single channel row to rgba, value is broadcasted to every channel
+static void BlitRow(uint8_t* dst, const uint8_t* src, int count)
+{
+	for (int i = 0; i < count; i++)
 	{
-		int w;
-		int h;
-		int xoff;
-		int yoff;
-		unsigned char* pixels; // TODO: memory leak
-	};
+		uint32_t value = src[i] * 0x01010101u;
+		memcpy(dst + (i * 4), &value, 4);
+	}
+}
 
-	auto glyphs = std::vector<glyph>(info.numGlyphs);
+// glyphs in order of their coverage index
+static std::vector<uint16_t> ReadCoverage(const uint8_t* coverage)
+{
+	std::vector<uint16_t> result;
+	auto format = ReadU16(coverage);
 
-	for (int i = 0; i < info.numGlyphs; i++)
+	if (format == 1)
 	{
-		const int Onedge = int(SdfOnedge * 255.0f);
-		const float PixelDistScale = Onedge / SdfPadding;
+		auto count = ReadU16(coverage + 2);
+
+		for (int i = 0; i < count; i++)
+		{
+			result.push_back(ReadU16(coverage + 4 + (2 * i)));
+		}
+	}
+	else if (format == 2)
+	{
+		auto count = ReadU16(coverage + 2);
+
+		for (int i = 0; i < count; i++)
+		{
+			auto range = coverage + 4 + (6 * i);
+			auto start = ReadU16(range);
+			auto end = ReadU16(range + 2);
+			auto start_index = ReadU16(range + 4);
+
+			for (int glyph = start; glyph <= end; glyph++)
+			{
+				auto index = static_cast<size_t>(start_index + glyph - start);
+
+				if (result.size() <= index)
+					result.resize(index + 1);
 
-		auto& g = glyphs[i];
-		g.pixels = stbtt_GetGlyphSDF(&info, scale, i, (int)SdfPadding, Onedge, PixelDistScale, &g.w, &g.h, &g.xoff, &g.yoff);
+				result[index] = static_cast<uint16_t>(glyph);
+			}
+		}
 	}
 
-	using namespace rectpack2D;
-	constexpr bool allow_flip = false;
-	const auto runtime_flipping_mode = flipping_option::DISABLED;
-	using spaces_type = empty_spaces<allow_flip, default_empty_spaces>;
-	using rect_type = output_rect_t<spaces_type>;
+	return result;
+}
 
-	std::vector<rect_type> rectangles;
+template <typename Callback>
+static void ReadClassDef(const uint8_t* class_def, Callback&& callback)
+{
+	auto format = ReadU16(class_def);
 
-	for (const auto& g : glyphs)
+	if (format == 1)
 	{
-		rectangles.emplace_back(rect_xywh(0, 0, g.w, g.h));
+		auto start = ReadU16(class_def + 2);
+		auto count = ReadU16(class_def + 4);
+
+		for (int i = 0; i < count; i++)
+		{
+			callback(static_cast<uint16_t>(start + i), ReadU16(class_def + 6 + (2 * i)));
+		}
 	}
+	else if (format == 2)
+	{
+		auto count = ReadU16(class_def + 2);
 
-	auto report_successful = [](rect_type&) {
-		return callback_result::CONTINUE_PACKING;
-	};
+		for (int i = 0; i < count; i++)
+		{
+			auto range = class_def + 4 + (6 * i);
+			auto start = ReadU16(range);
+			auto end = ReadU16(range + 2);
+			auto value = ReadU16(range + 4);
 
-	auto report_unsuccessful = [](rect_type&) {
-		return callback_result::ABORT_PACKING;
-	};
+			for (int glyph = start; glyph <= end; glyph++)
+			{
+				callback(static_cast<uint16_t>(glyph), value);
+			}
+		}
+	}
+}
 
-	const auto max_side = 1 << 12;
-	const auto discard_step = 1;
+static const uint32_t CacheMagic = 0x43464B53; // SKFC
+static const uint32_t CacheVersion = 2;
 
-	const auto finder_input = make_finder_input(max_side, discard_step, report_successful, report_unsuccessful, runtime_flipping_mode);
-	const auto result_size = find_best_packing<spaces_type>(rectangles, finder_input);
+Font::Font(void* data, size_t size) : Font(data, size, nullptr, 0)
+{
+}
 
-	for (int i = 0; i < 65535; i++)
-	{
-		auto g_index = stbtt_FindGlyphIndex(&info, i);
+Font::Font(const sky::Asset& asset) : Font(asset.getMemory(), asset.getSize())
+{
+}
 
-		if (g_index == 0 && i != 0)
-			continue;
+Font::Font(const sky::Asset& asset, const sky::Asset& cache) :
+	Font(asset.getMemory(), asset.getSize(), cache.getMemory(), cache.getSize())
+{
+}
+
+Font::Font(void* data, size_t size, const void* cache, size_t cache_size) :
+	mData((uint8_t*)data, (uint8_t*)data + size),
+	mInfo(std::make_unique<stbtt_fontinfo>()),
+	mGlyphTable(std::make_unique<std::atomic<GlyphBlock*>[]>(MaxCodepoint / GlyphBlockSize))
+{
+	stbtt_InitFont(mInfo.get(), mData.data(), 0);
+
+	mScale = stbtt_ScaleForPixelHeight(mInfo.get(), GlyphSize);
+
+	int ascent = 0;
+	int descent = 0;
+	int linegap = 0;
 
-		int xadvance;
-		stbtt_GetCodepointHMetrics(&info, i, &xadvance, nullptr);
-		auto& _glyph = mGlyphs[i];
-		const auto& rect = rectangles.at(g_index);
-		const auto& g = glyphs.at(g_index);
-		_glyph.pos.x = static_cast<float>(rect.x);
-		_glyph.pos.y = static_cast<float>(rect.y);
-		_glyph.size.x = static_cast<float>(rect.w);
-		_glyph.size.y = static_cast<float>(rect.h);
-		_glyph.offset.x = static_cast<float>(g.xoff);
-		_glyph.offset.y = static_cast<float>(g.yoff);
-		_glyph.xadvance = static_cast<float>(xadvance) * scale;
+	stbtt_GetFontVMetrics(mInfo.get(), &ascent, &descent, &linegap);
+
+	mAscent = ascent * mScale;
+	mDescent = descent * mScale;
+	mLinegap = linegap * mScale;
+
+	if (cache != nullptr && readCache(cache, cache_size))
+	{
+		mLoadedFromCache = true;
+		return;
 	}
 
-	for (const auto& [left_index, left_glyph] : mGlyphs)
+	readKerning();
+
+	// null symbol is a fallback for missing ones, so it always exists
+	getGlyph(0);
+	warmup(GetBasicLatinSymbols());
+}
+
+Font::~Font()
+{
+	std::lock_guard lock(PendingMutex);
+	PendingFonts.erase(this);
+}
+
+uint32_t Font::GetCacheKey(const void* data, size_t size)
+{
+	const float params[] = { GlyphSize, SdfPadding, SdfOnedge, (float)PageSize, (float)Spacing, (float)CacheVersion };
+	auto crc = Common::Helpers::crc32(const_cast<void*>(data), size);
+	return Common::Helpers::crc32((void*)params, sizeof(params), crc);
+}
+
+void Font::writeCache(sky::BitBuffer& buf) const
+{
+	std::lock_guard lock(mMutex);
+
+	buf.write<uint32_t>(CacheMagic);
+	buf.write<uint32_t>(CacheVersion);
+	buf.write<uint32_t>(GetCacheKey(mData.data(), mData.size()));
+	buf.write<uint64_t>(mData.size());
+	buf.write<float>(mAscent);
+	buf.write<float>(mDescent);
+	buf.write<float>(mLinegap);
+
+	buf.write<uint32_t>(static_cast<uint32_t>(mPages.size()));
+
+	auto row = std::vector<uint8_t>(PageSize);
+
+	for (const auto& page : mPages)
 	{
-		for (const auto& [right_index, right_glyph] : mGlyphs)
+		buf.write<uint32_t>(page.height);
+		buf.write<uint32_t>(static_cast<uint32_t>(page.shelves.size()));
+		buf.write((void*)page.shelves.data(), page.shelves.size() * sizeof(glm::uvec3));
+
+		// channels are equal, only first one of used rows is stored
+		for (uint32_t y = 0; y < page.height; y++)
 		{
-			auto kern = stbtt_GetCodepointKernAdvance(&info, left_index, right_index);
+			for (uint32_t x = 0; x < PageSize; x++)
+			{
+				row[x] = page.pixels[((y * PageSize) + x) * 4];
+			}
 
-			if (kern == 0.0f)
-				continue;
+			buf.write(row.data(), row.size());
+		}
+	}
+
+	buf.write<uint32_t>(static_cast<uint32_t>(mRasterized.size()));
+
+	for (const auto& [glyph_index, glyph] : mRasterized)
+	{
+		buf.write<int32_t>(glyph_index);
+		buf.write<Glyph>(glyph);
+	}
+
+	std::vector<std::pair<uint32_t, int32_t>> symbols;
+
+	for (uint32_t code = 0; code < MaxCodepoint; code += GlyphBlockSize)
+	{
+		auto block = mGlyphTable[code / GlyphBlockSize].load();
 
-			mKernings[left_index][right_index] = kern * scale;
+		if (block == nullptr)
+			continue;
+
+		for (uint32_t i = 0; i < GlyphBlockSize; i++)
+		{
+			if (auto glyph = (*block)[i].load(); glyph != nullptr)
+				symbols.push_back({ code + i, glyph->index });
 		}
 	}
 
-	const auto dst_width = result_size.w;
-	const auto dst_height = result_size.h;
-	const int channels = 4;
-	auto image = Graphics::Image(dst_width, dst_height, channels);
+	buf.write<uint32_t>(static_cast<uint32_t>(symbols.size()));
+
+	for (const auto& [code, glyph_index] : symbols)
+	{
+		buf.write<uint32_t>(code);
+		buf.write<int32_t>(glyph_index);
+	}
+
+	buf.write<uint32_t>(static_cast<uint32_t>(mKernings.size()));
+	buf.write((void*)mKernings.data(), mKernings.size() * sizeof(KerningPair));
+}
+
+bool Font::readCache(const void* memory, size_t size)
+{
+	auto buf = sky::BitBuffer();
+	buf.write(const_cast<void*>(memory), size);
+	buf.toStart();
+
+	auto can_read = [&](size_t bytes) {
+		return buf.getRemaining() >= bytes;
+	};
+
+	const size_t HeaderSize = (sizeof(uint32_t) * 3) + sizeof(uint64_t) + (sizeof(float) * 3) + sizeof(uint32_t);
+
+	if (!can_read(HeaderSize))
+		return false;
+
+	if (buf.read<uint32_t>() != CacheMagic)
+		return false;
+
+	if (buf.read<uint32_t>() != CacheVersion)
+		return false;
+
+	if (buf.read<uint32_t>() != GetCacheKey(mData.data(), mData.size()))
+		return false;
+
+	if (buf.read<uint64_t>() != mData.size())
+		return false;
+
+	auto ascent = buf.read<float>();
+	auto descent = buf.read<float>();
+	auto linegap = buf.read<float>();
+
+	// everything is read into locals first, font stays untouched on mismatch
+
+	auto pages_count = buf.read<uint32_t>();
 
-	for (int i = 0; i < info.numGlyphs; i++)
+	if (!can_read(pages_count * sizeof(uint32_t) * 2))
+		return false;
+
+	auto pages = std::vector<Page>(pages_count);
+
+	for (auto& page : pages)
 	{
-		auto& r = rectangles[i];
-		auto& g = glyphs[i];
-		for (int x = 0; x < r.w; x++)
+		if (!can_read(sizeof(uint32_t) * 2))
+			return false;
+
+		page.height = buf.read<uint32_t>();
+		auto shelves_count = buf.read<uint32_t>();
+
+		if (page.height > PageSize || !can_read((shelves_count * sizeof(glm::uvec3)) + (page.height * PageSize)))
+			return false;
+
+		page.shelves.resize(shelves_count);
+		buf.read(page.shelves.data(), page.shelves.size() * sizeof(glm::uvec3));
+		page.pixels.resize(PageSize * PageSize * 4, 0);
+
+		auto row = std::vector<uint8_t>(PageSize);
+
+		for (uint32_t y = 0; y < page.height; y++)
 		{
-			for (int y = 0; y < r.h; y++)
-			{
-				auto pixel = image.getPixel(r.x + x, r.y + y);
-				memset(pixel, g.pixels[x + (y * r.w)], channels);
-			}
+			buf.read(row.data(), row.size());
+			BlitRow(&page.pixels[y * PageSize * 4], row.data(), PageSize);
 		}
 	}
 
-	mTexture = std::make_shared<skygfx::Texture>(image.getWidth(), image.getHeight(), skygfx::PixelFormat::RGBA8UNorm,
-		image.getMemory());
+	if (!can_read(sizeof(uint32_t)))
+		return false;
 
-	int ascent = 0;
-	int descent = 0;
-	int linegap = 0;
+	auto rasterized_count = buf.read<uint32_t>();
+
+	if (!can_read(rasterized_count * (sizeof(int32_t) + sizeof(Glyph))))
+		return false;
+
+	auto rasterized = std::unordered_map<int, Glyph>();
+
+	for (uint32_t i = 0; i < rasterized_count; i++)
+	{
+		auto glyph_index = buf.read<int32_t>();
+		auto glyph = buf.read<Glyph>();
+
+		if (glyph.page >= pages.size() && glyph.size.x > 0.0f)
+			return false;
+
+		rasterized.insert({ glyph_index, glyph });
+	}
+
+	if (!can_read(sizeof(uint32_t)))
+		return false;
+
+	auto glyphs_count = buf.read<uint32_t>();
 
-	stbtt_GetFontVMetrics(&info, &ascent, &descent, &linegap);
+	if (!can_read(glyphs_count * (sizeof(uint32_t) + sizeof(int32_t))))
+		return false;
 
-	mAscent = ascent * scale;
-	mDescent = descent * scale;
-	mLinegap = linegap * scale;
+	auto symbols = std::vector<std::pair<uint32_t, int32_t>>(glyphs_count);
+
+	for (auto& [code, glyph_index] : symbols)
+	{
+		code = buf.read<uint32_t>();
+		glyph_index = buf.read<int32_t>();
+
+		if (code >= MaxCodepoint || !rasterized.contains(glyph_index))
+			return false;
+	}
+
+	if (!can_read(sizeof(uint32_t)))
+		return false;
+
+	auto kernings = std::vector<KerningPair>(buf.read<uint32_t>());
+
+	if (!can_read(kernings.size() * sizeof(KerningPair)))
+		return false;
+
+	buf.read(kernings.data(), kernings.size() * sizeof(KerningPair));
+
+	for (auto& page : pages)
+	{
+		page.dirty_top = 0;
+		page.dirty_bottom = page.height;
+	}
+
+	{
+		std::lock_guard lock(mMutex);
+		mAscent = ascent;
+		mDescent = descent;
+		mLinegap = linegap;
+		mPages = std::move(pages);
+		mRasterized = std::move(rasterized);
+		mKernings = std::move(kernings);
+
+		for (const auto& [code, glyph_index] : symbols)
+		{
+			publishGlyph(code, mRasterized.at(glyph_index));
+		}
+	}
+
+	std::lock_guard lock(PendingMutex);
+	PendingFonts.insert(this);
+	HasPending = true;
+
+	return true;
 }
 
-Font::Font(const sky::Asset& asset) : Font(asset.getMemory(), asset.getSize())
+std::shared_ptr<skygfx::Texture> Font::getTexture(uint32_t page) const
 {
+	std::lock_guard lock(mMutex);
+
+	if (page >= mPages.size())
+		return nullptr;
+
+	return mPages.at(page).texture;
 }
 
-Font::~Font()
+size_t Font::getPagesCount() const
 {
+	std::lock_guard lock(mMutex);
+	return mPages.size();
 }
 
 float Font::getScaleFactorForSize(float size)
@@ -143,21 +406,512 @@ float Font::getScaleFactorForSize(float size)
 
 const Font::Glyph& Font::getGlyph(wchar_t symbol) const
 {
-	if (mGlyphs.count(symbol) == 0)
-		return mGlyphs.at(0);
+	auto code = static_cast<uint32_t>(symbol);
+
+	if (code >= MaxCodepoint)
+		return getGlyph(0);
+
+	if (auto glyph = findGlyph(code); glyph != nullptr)
+		return *glyph;
+
+	std::lock_guard lock(mMutex);
+
+	if (auto glyph = findGlyph(code); glyph != nullptr)
+		return *glyph;
+
+	// missing symbols get glyph 0, same as null symbol
+	const auto& glyph = rasterize(stbtt_FindGlyphIndex(mInfo.get(), symbol));
+	publishGlyph(code, glyph);
+	return glyph;
+}
+
+const Font::Glyph* Font::findGlyph(uint32_t code) const
+{
+	auto block = mGlyphTable[code / GlyphBlockSize].load(std::memory_order_acquire);
+
+	if (block == nullptr)
+		return nullptr;
+
+	return (*block)[code % GlyphBlockSize].load(std::memory_order_acquire);
+}
+
+void Font::publishGlyph(uint32_t code, const Glyph& glyph) const
+{
+	auto& slot = mGlyphTable[code / GlyphBlockSize];
+	auto block = slot.load(std::memory_order_relaxed);
+
+	if (block == nullptr)
+	{
+		block = mGlyphBlocks.emplace_back(std::make_unique<GlyphBlock>()).get();
+		slot.store(block, std::memory_order_release);
+	}
 
-	return mGlyphs.at(symbol);
+	(*block)[code % GlyphBlockSize].store(&glyph, std::memory_order_release);
 }
 
 float Font::getKerning(wchar_t left, wchar_t right) const
 {
-	if (mKernings.count(left) == 0)
+	if (mKernings.empty())
 		return 0.0f;
 
-	const auto& left_kern = mKernings.at(left);
+	auto key = MakeKerningKey(getGlyph(left).index, getGlyph(right).index);
+
+	auto it = std::lower_bound(mKernings.begin(), mKernings.end(), key, [](const KerningPair& pair, uint32_t key) {
+		return pair.key < key;
+	});
 
-	if (left_kern.count(right) == 0)
+	if (it == mKernings.end() || it->key != key)
 		return 0.0f;
 
-	return left_kern.at(right);
+	return it->advance;
+}
+
+void Font::readKerning()
+{
+	// same source as stbtt_GetGlyphKernAdvance uses, gpos has priority over kern
+	if (mInfo->gpos != 0)
+		readKerningFromGpos();
+	else if (mInfo->kern != 0)
+		readKerningFromKern();
+
+	// first record of a pair wins, as in table lookup order
+	std::stable_sort(mKernings.begin(), mKernings.end(), [](const KerningPair& left, const KerningPair& right) {
+		return left.key < right.key;
+	});
+
+	auto last = std::unique(mKernings.begin(), mKernings.end(), [](const KerningPair& left, const KerningPair& right) {
+		return left.key == right.key;
+	});
+
+	// zero records are kept until here, they hide records of later subtables
+	last = std::remove_if(mKernings.begin(), last, [](const KerningPair& pair) {
+		return pair.advance == 0.0f;
+	});
+
+	mKernings.erase(last, mKernings.end());
+	mKernings.shrink_to_fit();
+}
+
+void Font::readKerningFromKern()
+{
+	auto kern = mInfo->data + mInfo->kern;
+
+	// only first table is used, it must be horizontal and format 0, same as in stb_truetype
+	if (ReadU16(kern + 2) < 1 || ReadU16(kern + 8) != 1)
+		return;
+
+	auto pair_count = ReadU16(kern + 10);
+
+	mKernings.reserve(pair_count);
+
+	for (int i = 0; i < pair_count; i++)
+	{
+		auto record = kern + 18 + (6 * i);
+		auto advance = ReadS16(record + 4);
+
+		if (advance == 0)
+			continue;
+
+		auto key = MakeKerningKey(ReadU16(record), ReadU16(record + 2));
+		mKernings.push_back({ .key = key, .advance = static_cast<float>(advance) * mScale });
+	}
+}
+
+void Font::readKerningFromGpos()
+{
+	auto gpos = mInfo->data + mInfo->gpos;
+
+	if (ReadU16(gpos) != 1 || ReadU16(gpos + 2) != 0) // version 1.0
+		return;
+
+	// stb_truetype stops at first subtable which resolves a pair, even to zero,
+	// so zero records are added too and subtables with unsupported values resolve their glyphs
+	auto resolved = std::vector<bool>(mInfo->numGlyphs, false);
+
+	auto add = [&](uint16_t left, uint16_t right, int16_t advance) {
+		if (left < resolved.size() && resolved[left])
+			return;
+
+		mKernings.push_back({ .key = MakeKerningKey(left, right), .advance = static_cast<float>(advance) * mScale });
+	};
+
+	auto lookup_list = gpos + ReadU16(gpos + 8);
+	auto lookup_count = ReadU16(lookup_list);
+
+	for (int i = 0; i < lookup_count; i++)
+	{
+		auto lookup = lookup_list + ReadU16(lookup_list + 2 + (2 * i));
+
+		if (ReadU16(lookup) != 2) // pair adjustment
+			continue;
+
+		auto subtable_count = ReadU16(lookup + 4);
+
+		for (int j = 0; j < subtable_count; j++)
+		{
+			auto subtable = lookup + ReadU16(lookup + 6 + (2 * j));
+			auto format = ReadU16(subtable);
+			auto value_format1 = ReadU16(subtable + 4);
+			auto value_format2 = ReadU16(subtable + 6);
+
+			if (format != 1 && format != 2)
+				continue;
+
+			auto coverage = ReadCoverage(subtable + ReadU16(subtable + 2));
+
+			// only x advance of first glyph is supported, same as in stb_truetype
+			if (value_format1 != 4 || value_format2 != 0)
+			{
+				for (auto left : coverage)
+				{
+					if (left < resolved.size())
+						resolved[left] = true;
+				}
+
+				continue;
+			}
+
+			if (format == 1)
+			{
+				auto pair_set_count = ReadU16(subtable + 8);
+
+				for (size_t k = 0; k < coverage.size() && k < pair_set_count; k++)
+				{
+					auto pair_set = subtable + ReadU16(subtable + 10 + (2 * k));
+					auto pair_count = ReadU16(pair_set);
+
+					for (int l = 0; l < pair_count; l++)
+					{
+						auto record = pair_set + 2 + (4 * l);
+						add(coverage[k], ReadU16(record), ReadS16(record + 2));
+					}
+				}
+			}
+			else
+			{
+				auto class1_count = ReadU16(subtable + 12);
+				auto class2_count = ReadU16(subtable + 14);
+				auto records = subtable + 16;
+
+				// glyphs missing in class definition get no class in stb_truetype, their pairs are not resolved here,
+				// listed glyphs of class 0 are resolved as any other class
+				auto glyph_classes = std::vector<int>(mInfo->numGlyphs, -1);
+
+				ReadClassDef(subtable + ReadU16(subtable + 8), [&](uint16_t glyph, uint16_t value) {
+					if (glyph < glyph_classes.size())
+						glyph_classes[glyph] = value;
+				});
+
+				auto class2_glyphs = std::vector<std::vector<uint16_t>>(class2_count);
+
+				ReadClassDef(subtable + ReadU16(subtable + 10), [&](uint16_t glyph, uint16_t value) {
+					if (value < class2_count)
+						class2_glyphs[value].push_back(glyph);
+				});
+
+				for (auto left : coverage)
+				{
+					auto class1 = left < glyph_classes.size() ? glyph_classes[left] : -1;
+
+					if (class1 < 0 || class1 >= class1_count)
+						continue;
+
+					for (int class2 = 0; class2 < class2_count; class2++)
+					{
+						auto advance = ReadS16(records + (2 * ((class1 * class2_count) + class2)));
+
+						for (auto right : class2_glyphs[class2])
+						{
+							add(left, right, advance);
+						}
+					}
+				}
+			}
+		}
+	}
+}
+
+struct Font::SdfBitmap
+{
+	unsigned char* pixels = nullptr;
+	int width = 0;
+	int height = 0;
+	int xoff = 0;
+	int yoff = 0;
+};
+
+Font::SdfBitmap Font::GenerateSdf(const stbtt_fontinfo& info, float scale, int glyph_index)
+{
+	const int Onedge = int(SdfOnedge * 255.0f);
+	const float PixelDistScale = Onedge / SdfPadding;
+
+	SdfBitmap result;
+	result.pixels = stbtt_GetGlyphSDF(&info, scale, glyph_index, (int)SdfPadding, Onedge, PixelDistScale,
+		&result.width, &result.height, &result.xoff, &result.yoff);
+	return result;
+}
+
+void Font::warmup(const std::wstring& symbols) const
+{
+	std::vector<int> glyph_indices;
+
+	{
+		std::lock_guard lock(mMutex);
+
+		for (auto symbol : symbols)
+		{
+			if (static_cast<uint32_t>(symbol) >= MaxCodepoint || findGlyph(symbol) != nullptr)
+				continue;
+
+			auto glyph_index = stbtt_FindGlyphIndex(mInfo.get(), symbol);
+
+			if (mRasterized.contains(glyph_index))
+				continue;
+
+			if (std::find(glyph_indices.begin(), glyph_indices.end(), glyph_index) != glyph_indices.end())
+				continue;
+
+			glyph_indices.push_back(glyph_index);
+		}
+	}
+
+	// workers only read font data, glyphs are packed on this thread in symbols order.
+	// this thread takes jobs too and does not wait for tasks that were not started,
+	// so warmup from pool thread does not deadlock, late tasks find nothing to do
+
+	struct Job
+	{
+		const stbtt_fontinfo* info;
+		float scale;
+		std::vector<int> glyph_indices;
+		std::vector<SdfBitmap> bitmaps;
+		std::atomic<size_t> next = 0;
+		std::atomic<size_t> done = 0;
+	};
+
+	auto job = std::make_shared<Job>();
+	job->info = mInfo.get();
+	job->scale = mScale;
+	job->glyph_indices = std::move(glyph_indices);
+	job->bitmaps.resize(job->glyph_indices.size());
+
+	auto work = [job] {
+		for (auto i = job->next++; i < job->glyph_indices.size(); i = job->next++)
+		{
+			job->bitmaps[i] = GenerateSdf(*job->info, job->scale, job->glyph_indices[i]);
+			job->done++;
+		}
+	};
+
+	const size_t MinGlyphsPerTask = 16;
+	auto count = job->glyph_indices.size();
+
+	if (count >= MinGlyphsPerTask * 2 && sky::Locator<sky::ThreadPool>::Exists())
+	{
+		auto tasks = glm::min(THREADPOOL->getThreadsCount(), count / MinGlyphsPerTask);
+
+		for (size_t i = 0; i < tasks; i++)
+		{
+			THREADPOOL->addTask(work);
+		}
+	}
+
+	work();
+
+	while (job->done < count)
+	{
+		std::this_thread::yield();
+	}
+
+	{
+		std::lock_guard lock(mMutex);
+
+		for (size_t i = 0; i < count; i++)
+		{
+			add(job->glyph_indices[i], job->bitmaps[i]);
+		}
+	}
+
+	for (auto symbol : symbols)
+	{
+		getGlyph(symbol);
+	}
+}
+
+const Font::Glyph& Font::rasterize(int glyph_index) const
+{
+	if (auto it = mRasterized.find(glyph_index); it != mRasterized.end())
+		return it->second;
+
+	return add(glyph_index, GenerateSdf(*mInfo, mScale, glyph_index));
+}
+
+const Font::Glyph& Font::add(int glyph_index, const SdfBitmap& bitmap) const
+{
+	if (auto it = mRasterized.find(glyph_index); it != mRasterized.end())
+	{
+		stbtt_FreeSDF(bitmap.pixels, nullptr);
+		return it->second;
+	}
+
+	int xadvance = 0;
+	stbtt_GetGlyphHMetrics(mInfo.get(), glyph_index, &xadvance, nullptr);
+
+	auto w = bitmap.width;
+	auto h = bitmap.height;
+
+	auto& glyph = mRasterized[glyph_index];
+	glyph.pos = { 0.0f, 0.0f };
+	glyph.size = { static_cast<float>(w), static_cast<float>(h) };
+	glyph.offset = { static_cast<float>(bitmap.xoff), static_cast<float>(bitmap.yoff) };
+	glyph.xadvance = static_cast<float>(xadvance) * mScale;
+	glyph.index = static_cast<uint16_t>(glyph_index);
+
+	if (bitmap.pixels == nullptr) // whitespace has no bitmap
+		return glyph;
+
+	auto padded_width = static_cast<uint32_t>(w) + (Spacing * 2);
+	auto padded_height = static_cast<uint32_t>(h) + (Spacing * 2);
+
+	auto place = [&](size_t page_index, glm::uvec3& shelf) {
+		auto& page = mPages[page_index];
+		auto x = shelf.x + Spacing;
+		auto y = shelf.y + Spacing;
+		shelf.x += padded_width;
+
+		for (int row = 0; row < h; row++)
+		{
+			BlitRow(&page.pixels[(((y + row) * PageSize) + x) * 4], bitmap.pixels + (row * w), w);
+		}
+
+		page.dirty_top = glm::min(page.dirty_top, y);
+		page.dirty_bottom = glm::max(page.dirty_bottom, y + static_cast<uint32_t>(h));
+
+		glyph.pos = { static_cast<float>(x), static_cast<float>(y) };
+		glyph.page = static_cast<uint32_t>(page_index);
+	};
+
+	auto placed = false;
+
+	for (size_t i = 0; i < mPages.size() && !placed; i++)
+	{
+		auto& page = mPages[i];
+
+		for (auto& shelf : page.shelves)
+		{
+			if (shelf.z < padded_height || shelf.x + padded_width > PageSize)
+				continue;
+
+			place(i, shelf);
+			placed = true;
+			break;
+		}
+
+		if (placed || page.height + padded_height > PageSize)
+			continue;
+
+		page.shelves.push_back({ 0, page.height, padded_height });
+		page.height += padded_height;
+		place(i, page.shelves.back());
+		placed = true;
+	}
+
+	if (!placed)
+	{
+		auto& page = mPages.emplace_back();
+		page.pixels.resize(PageSize * PageSize * 4, 0);
+		page.shelves.push_back({ 0, 0, padded_height });
+		page.height = padded_height;
+		place(mPages.size() - 1, page.shelves.back());
+	}
+
+	stbtt_FreeSDF(bitmap.pixels, nullptr);
+
+	std::lock_guard lock(PendingMutex);
+	PendingFonts.insert(this);
+	HasPending = true;
+
+	return glyph;
+}
+
+void Font::upload() const
+{
+	std::lock_guard lock(mMutex);
+
+	// headless renderer has no device, pages stay on cpu side and glyphs are drawn untextured
+	auto headless = sky::Locator<sky::Renderer>::Exists() && RENDERER->isHeadless();
+
+	for (auto& page : mPages)
+	{
+		if (headless)
+		{
+			// nothing to upload to
+		}
+		else if (page.texture == nullptr)
+		{
+			page.texture = std::make_shared<skygfx::Texture>(PageSize, PageSize, skygfx::PixelFormat::RGBA8UNorm,
+				page.pixels.data());
+		}
+		else if (page.dirty_top < page.dirty_bottom)
+		{
+			auto rows = page.dirty_bottom - page.dirty_top;
+			auto memory = &page.pixels[page.dirty_top * PageSize * 4];
+			page.texture->write(PageSize, rows, skygfx::PixelFormat::RGBA8UNorm, memory, 0, 0, page.dirty_top);
+		}
+
+		page.dirty_top = PageSize;
+		page.dirty_bottom = 0;
+	}
+}
+
+void Font::UploadPending()
+{
+	if (!HasPending)
+		return;
+
+	std::unordered_set<const Font*> fonts;
+
+	{
+		std::lock_guard lock(PendingMutex);
+		std::swap(fonts, PendingFonts);
+		HasPending = false;
+	}
+
+	for (auto font : fonts)
+	{
+		font->upload();
+	}
+}
+
+const std::wstring& Font::GetBasicLatinSymbols()
+{
+	static const auto result = [] {
+		std::wstring symbols;
+		for (wchar_t symbol = 0x20; symbol <= 0x7E; symbol++)
+			symbols.push_back(symbol);
+		return symbols;
+	}();
+	return result;
+}
+
+const std::wstring& Font::GetLatinSupplementSymbols()
+{
+	static const auto result = [] {
+		std::wstring symbols;
+		for (wchar_t symbol = 0xA0; symbol <= 0xFF; symbol++)
+			symbols.push_back(symbol);
+		return symbols;
+	}();
+	return result;
+}
+
+const std::wstring& Font::GetCyrillicSymbols()
+{
+	static const auto result = [] {
+		std::wstring symbols;
+		for (wchar_t symbol = 0x400; symbol <= 0x45F; symbol++)
+			symbols.push_back(symbol);
+		return symbols;
+	}();
+	return result;
 }
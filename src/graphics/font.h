@@ -1,19 +1,36 @@
 #pragma once
 
 #include <sky/asset.h>
+#include <common/bitbuffer.h>
 #include <unordered_map>
+#include <array>
+#include <unordered_set>
 #include <memory>
+#include <mutex>
+#include <atomic>
+#include <string>
+#include <vector>
 #include <glm/glm.hpp>
 #include <skygfx/skygfx.h>
 
+struct stbtt_fontinfo;
+
 namespace Graphics
 {
+	// glyphs are rasterized on first use and shelf packed into fixed size pages,
+	// changed rows of pages are uploaded on main thread before next gpu draw.
+	// glyph lookups are thread safe, texture access is main thread only
+
 	class Font
 	{
 	public:
 		static inline const float GlyphSize = 32.0f;
 		static inline const float SdfPadding = GlyphSize / 8.0f;
 		static inline const float SdfOnedge = 0.5f;
+		static constexpr uint32_t PageSize = 1024;
+		static constexpr uint32_t Spacing = 1; // keeps linear filtering inside of glyph
+		static constexpr uint32_t MaxCodepoint = 0x110000; // higher ones get glyph 0
+		static constexpr uint32_t GlyphBlockSize = 256;
 
 	public:
 		struct Glyph
@@ -22,30 +39,99 @@ namespace Graphics
 			glm::vec2 size;
 			glm::vec2 offset;
 			float xadvance;
+			uint32_t page = 0;
+			uint16_t index = 0; // in font file, used for kerning
 		};
 
 	public:
 		Font(void* data, size_t size);
 		Font(const sky::Asset& asset);
+		Font(const sky::Asset& asset, const sky::Asset& cache); // full build when cache does not match
+		Font(void* data, size_t size, const void* cache, size_t cache_size);
 		~Font();
 
-		auto getTexture() const { return mTexture; }
+		// precompiled pages, glyphs, kerning and metrics, valid for same font data and generation parameters
+		static uint32_t GetCacheKey(const void* data, size_t size);
+		void writeCache(sky::BitBuffer& buf) const;
+		bool isLoadedFromCache() const { return mLoadedFromCache; }
+
+		std::shared_ptr<skygfx::Texture> getTexture(uint32_t page = 0) const;
+		size_t getPagesCount() const;
 		const Glyph& getGlyph(wchar_t symbol) const;
 
 		static float getScaleFactorForSize(float size);
 
 		float getKerning(wchar_t left, wchar_t right) const;
+		auto getKerningPairsCount() const { return mKernings.size(); }
 
 		float getAscent() const { return mAscent; }
 		float getDescent() const { return mDescent; }
 		float getLinegap() const { return mLinegap; }
 
+		// rasterizes symbols synchronously, so first frames with them do not stall,
+		// sdf generation of missing glyphs is split across thread pool workers
+		void warmup(const std::wstring& symbols) const;
+
+		// uploads changed rows of pages, creates textures for new pages
+		void upload() const;
+
+		static void UploadPending();
+
+		static const std::wstring& GetBasicLatinSymbols();
+		static const std::wstring& GetLatinSupplementSymbols();
+		static const std::wstring& GetCyrillicSymbols();
+
 	private:
-		std::shared_ptr<skygfx::Texture> mTexture = nullptr;
-		std::unordered_map<wchar_t, Glyph> mGlyphs;
-		std::unordered_map<wchar_t, std::unordered_map<wchar_t, float>> mKernings;
+		struct SdfBitmap;
+
+		static SdfBitmap GenerateSdf(const stbtt_fontinfo& info, float scale, int glyph_index);
+
+		const Glyph* findGlyph(uint32_t code) const; // lock free
+		void publishGlyph(uint32_t code, const Glyph& glyph) const;
+		const Glyph& rasterize(int glyph_index) const;
+		const Glyph& add(int glyph_index, const SdfBitmap& bitmap) const; // takes ownership of pixels
+		bool readCache(const void* memory, size_t size);
+		void readKerning();
+		void readKerningFromKern();
+		void readKerningFromGpos();
+
+	private:
+		struct Page
+		{
+			std::shared_ptr<skygfx::Texture> texture;
+			std::vector<uint8_t> pixels; // rgba
+			std::vector<glm::uvec3> shelves; // x cursor, y, height
+			uint32_t height = 0;
+			uint32_t dirty_top = PageSize;
+			uint32_t dirty_bottom = 0;
+		};
+
+		struct KerningPair
+		{
+			uint32_t key; // left glyph index in high half, right in low
+			float advance;
+		};
+
+		std::vector<uint8_t> mData;
+		std::unique_ptr<stbtt_fontinfo> mInfo;
+		float mScale = 0.0f;
+		mutable std::mutex mMutex;
+		mutable std::vector<Page> mPages;
+
+		// two level table by codepoint, slots are written once under mutex and read without it,
+		// glyphs are owned by mRasterized whose nodes never move
+		using GlyphBlock = std::array<std::atomic<const Glyph*>, GlyphBlockSize>;
+		std::unique_ptr<std::atomic<GlyphBlock*>[]> mGlyphTable;
+		mutable std::vector<std::unique_ptr<GlyphBlock>> mGlyphBlocks;
+		mutable std::unordered_map<int, Glyph> mRasterized; // by glyph index, codepoints can share glyph
+		std::vector<KerningPair> mKernings; // sorted by key
 		float mAscent = 0.0f;
 		float mDescent = 0.0f;
 		float mLinegap = 0.0f;
+		bool mLoadedFromCache = false;
+
+		static inline std::mutex PendingMutex;
+		static inline std::unordered_set<const Font*> PendingFonts;
+		static inline std::atomic<bool> HasPending = false;
 	};
 }
@@ -0,0 +1,129 @@
+#include "render_target_pool.h"
+#include <sky/utils.h>
+#include <sky/renderer.h>
+#include <algorithm>
+
+using namespace Graphics;
+
+std::shared_ptr<skygfx::RenderTarget> RenderTargetPool::acquire(uint32_t width, uint32_t height, skygfx::PixelFormat format)
+{
+	if (RENDERER->isHeadless()) // no device to create targets on, callers draw without them
+		return nullptr;
+
+	width = GetSizeClass(width);
+	height = GetSizeClass(height);
+
+	for (auto& entry : mEntries)
+	{
+		if (entry.leased || entry.format != format || entry.width != width || entry.height != height)
+			continue;
+
+		entry.leased = true;
+		entry.last_used_frame = mFrame;
+		mStats.leased += 1;
+		mStats.reuses += 1;
+		return entry.target;
+	}
+
+	size_t bytes = (size_t)width * (size_t)height * 4; // estimation, pixel size of format is not exposed
+
+	if (mStats.bytes + bytes > mBudget)
+		evict(bytes);
+
+	if (mStats.bytes + bytes > mBudget)
+		sky::Log("render target pool is over budget: {} of {} bytes", mStats.bytes + bytes, mBudget);
+
+	auto target = std::make_shared<skygfx::RenderTarget>(width, height, format);
+
+	mEntries.push_back({
+		.target = target,
+		.format = format,
+		.width = width,
+		.height = height,
+		.bytes = bytes,
+		.last_used_frame = mFrame,
+		.leased = true
+	});
+
+	mStats.targets += 1;
+	mStats.leased += 1;
+	mStats.bytes += bytes;
+	mStats.allocations += 1;
+
+	return target;
+}
+
+void RenderTargetPool::onFrame()
+{
+	std::erase_if(mEntries, [&](const Entry& entry) {
+		if (entry.leased || mFrame - entry.last_used_frame < StaleFrames)
+			return false;
+
+		mStats.targets -= 1;
+		mStats.bytes -= entry.bytes;
+		mStats.evictions += 1;
+		return true;
+	});
+
+	for (auto& entry : mEntries)
+	{
+		entry.leased = false;
+	}
+
+	mFrameStats = mStats;
+	mStats.leased = 0;
+	mStats.allocations = 0;
+	mStats.reuses = 0;
+	mFrame += 1;
+}
+
+void RenderTargetPool::clear()
+{
+	mEntries.clear();
+	mStats = {};
+}
+
+uint32_t RenderTargetPool::GetSizeClass(uint32_t value)
+{
+	value = std::max<uint32_t>(value, 1);
+	return ((value + SizeClassStep - 1) / SizeClassStep) * SizeClassStep;
+}
+
+void RenderTargetPool::evict(size_t required_bytes)
+{
+	// least recently used free targets first
+	std::vector<size_t> free_entries;
+
+	for (size_t i = 0; i < mEntries.size(); i++)
+	{
+		if (!mEntries[i].leased)
+			free_entries.push_back(i);
+	}
+
+	std::sort(free_entries.begin(), free_entries.end(), [&](size_t left, size_t right) {
+		return mEntries[left].last_used_frame < mEntries[right].last_used_frame;
+	});
+
+	std::vector<bool> evicted(mEntries.size(), false);
+
+	for (auto index : free_entries)
+	{
+		if (mStats.bytes + required_bytes <= mBudget)
+			break;
+
+		evicted[index] = true;
+		mStats.targets -= 1;
+		mStats.bytes -= mEntries[index].bytes;
+		mStats.evictions += 1;
+	}
+
+	std::vector<Entry> entries;
+
+	for (size_t i = 0; i < mEntries.size(); i++)
+	{
+		if (!evicted[i])
+			entries.push_back(std::move(mEntries[i]));
+	}
+
+	mEntries = std::move(entries);
+}
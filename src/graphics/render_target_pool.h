@@ -0,0 +1,64 @@
+#pragma once
+
+#include <skygfx/skygfx.h>
+#include <memory>
+#include <vector>
+
+namespace Graphics
+{
+	// transient render targets keyed by format and rounded size class,
+	// leases live until the end of frame, free targets are shared between all users
+
+	class RenderTargetPool
+	{
+	public:
+		static constexpr uint32_t SizeClassStep = 64;
+		static constexpr uint64_t StaleFrames = 60;
+
+		struct Entry
+		{
+			std::shared_ptr<skygfx::RenderTarget> target;
+			skygfx::PixelFormat format;
+			uint32_t width;
+			uint32_t height;
+			size_t bytes;
+			uint64_t last_used_frame = 0;
+			bool leased = false;
+		};
+
+		struct Stats
+		{
+			size_t targets = 0;
+			size_t leased = 0;
+			size_t bytes = 0;
+			int allocations = 0; // current frame
+			int reuses = 0; // current frame
+			int evictions = 0; // total
+		};
+
+	public:
+		std::shared_ptr<skygfx::RenderTarget> acquire(uint32_t width, uint32_t height, skygfx::PixelFormat format);
+		void onFrame();
+		void clear();
+
+		static uint32_t GetSizeClass(uint32_t value);
+
+	public:
+		const auto& getEntries() const { return mEntries; }
+		const auto& getStats() const { return mStats; }
+		const auto& getFrameStats() const { return mFrameStats; }
+
+		auto getBudget() const { return mBudget; }
+		void setBudget(size_t value) { mBudget = value; }
+
+	private:
+		void evict(size_t required_bytes);
+
+	private:
+		std::vector<Entry> mEntries;
+		Stats mStats;
+		Stats mFrameStats; // last finished frame
+		size_t mBudget = 256 * 1024 * 1024;
+		uint64_t mFrame = 0;
+	};
+}
@@ -1,12 +1,42 @@
 #include "system.h"
 #include <vector>
 #include <numeric>
+#include <algorithm>
+#include <iterator>
 #include <sky/renderer.h>
+#include <sky/utils.h>
 
 using namespace Graphics;
 
+namespace
+{
+	class RecordedEffect : public sky::effects::IEffect
+	{
+	public:
+		RecordedEffect(skygfx::Shader* shader, uint32_t binding, const std::vector<uint8_t>& data) :
+			mShader(shader), mBinding(binding), mData(data)
+		{
+		}
+
+		skygfx::Shader* getShader() const override { return mShader; }
+		uint32_t getUniformBinding() const override { return mBinding; }
+		void* getUniformData() const override { return (void*)mData.data(); }
+		size_t getUniformSize() const override { return mData.size(); }
+
+	private:
+		skygfx::Shader* mShader;
+		uint32_t mBinding;
+		const std::vector<uint8_t>& mData;
+	};
+}
+
+thread_local System::Context* System::CurrentContext = nullptr;
+
 System::System()
 {
+	if (RENDERER->isHeadless())
+		return;
+
 	mWhiteCircleTexture = makeGenericTexture({ 256, 256 }, [this] {
 		drawCircle();
 	});
@@ -14,40 +44,193 @@ System::System()
 
 void System::onFrame()
 {
-	mBatchesCountPublic = mBatchesCount;
-	mBatchesCount = 0;
-	mFlushCountPublic = mFlushCount;
-	mFlushCount = 0;
-
-	for (const auto& name : mUnusedRenderTargets)
-	{
-		mRenderTargets.erase(name);
-	}
+	mBatchesCountPublic = mContext.batches_count;
+	mContext.batches_count = 0;
+	mFlushCountPublic = mContext.flush_count;
+	mContext.flush_count = 0;
+
+	mRenderTargetPool.setBudget((size_t)std::max(0, (int)mRenderTargetBudget) * 1024 * 1024);
+	mRenderTargetPool.onFrame();
+	mTexturePages.collect();
+}
 
-	mUnusedRenderTargets.clear();
+System::Context& System::getContext()
+{
+	return CurrentContext != nullptr ? *CurrentContext : mContext;
+}
 
-	for (const auto& [name, target] : mRenderTargets)
-	{
-		mUnusedRenderTargets.insert(name);
-	}
+const System::Context& System::getContext() const
+{
+	return CurrentContext != nullptr ? *CurrentContext : mContext;
 }
 
 void System::begin()
 {
-	assert(!mWorking);
-	mWorking = true;
+	assert(!mContext.working);
+	assert(CurrentContext == nullptr);
+	mContext.working = true;
 	pushCleanState();
-	mAppliedState = std::nullopt;
+	mContext.applied_state = std::nullopt;
 }
 
 void System::end()
 {
-	assert(mWorking);
-	assert(mStates.size() == 1);
+	assert(mContext.working);
+	assert(mContext.states.size() == 1);
+	applyState();
+	flushBatch();
+	pop();
+	mContext.working = false;
+}
+
+void System::beginCommandList(CommandList& list, const State& state)
+{
+	assert(CurrentContext == nullptr);
+
+	auto& context = list.mContext;
+	assert(!context.working);
+
+	context.working = true;
+	context.deferred = true;
+	context.states = {};
+	context.states.push(state);
+	context.applied_state = std::nullopt;
+	context.batches_count = 0;
+	context.flush_count = 0;
+	context.packets.clear();
+
+	CurrentContext = &context;
+}
+
+void System::endCommandList()
+{
+	assert(CurrentContext != nullptr);
+	assert(CurrentContext->states.size() == 1);
 	applyState();
 	flushBatch();
 	pop();
-	mWorking = false;
+	CurrentContext->working = false;
+	CurrentContext = nullptr;
+}
+
+bool System::isRecordingCommandList() const
+{
+	return CurrentContext != nullptr;
+}
+
+void System::submit(CommandList& list)
+{
+	replay(list);
+	list.mContext.packets.clear();
+}
+
+void System::replay(const CommandList& list)
+{
+	assert(CurrentContext == nullptr);
+	assert(mContext.working);
+	assert(!list.mContext.working);
+
+	for (const auto& packet : list.mContext.packets)
+	{
+		std::visit(sky::cases{
+			[&](const BatchPacket& batch) {
+				push(batch.state);
+				applyState();
+
+				if (mContext.batch.topology != batch.topology || mContext.batch.texture != batch.texture)
+					flushBatch();
+
+				mContext.batch.texture = batch.texture;
+				mContext.batch.topology = batch.topology;
+
+				// vertices are already projected by recording thread
+				auto base_vertex = static_cast<uint32_t>(mContext.batch.vertices.size());
+				mContext.batch.vertices.insert(mContext.batch.vertices.end(), batch.vertices.begin(), batch.vertices.end());
+
+				for (auto index : batch.indices)
+				{
+					mContext.batch.indices.push_back(base_vertex + index);
+				}
+
+				pop();
+			},
+			[&](const DrawPacket& draw_packet) {
+				push(draw_packet.state);
+
+				auto effect = RecordedEffect(draw_packet.shader, draw_packet.uniform_binding, draw_packet.uniform_data);
+				auto effect_ptr = draw_packet.has_effect ? &effect : nullptr;
+
+				if (draw_packet.mesh != nullptr)
+				{
+					draw(effect_ptr, draw_packet.texture, draw_packet.topology, *draw_packet.mesh);
+				}
+				else if (!draw_packet.glyphs.empty())
+				{
+					auto glyph_count = static_cast<uint32_t>(draw_packet.glyphs.size());
+
+					if (!RENDERER->isHeadless())
+					{
+						auto& vertices = mContext.glyph_vertices;
+						auto& indices = mContext.glyph_indices;
+						vertices.clear();
+						indices.clear();
+						sky::TextMesh::AppendQuads(draw_packet.glyphs.data(), draw_packet.glyphs.size(),
+							draw_packet.glyphs.front().page, vertices, indices);
+						mMesh.setVertices(vertices);
+						mMesh.setIndices(indices);
+					}
+					draw(effect_ptr, draw_packet.texture, draw_packet.topology, mMesh, glyph_count * 4, glyph_count * 6);
+				}
+				else
+				{
+					auto vertex_count = static_cast<uint32_t>(draw_packet.vertices.size());
+					auto index_count = static_cast<uint32_t>(draw_packet.indices.size());
+
+					if (!RENDERER->isHeadless())
+					{
+						mMesh.setVertices(draw_packet.vertices);
+						mMesh.setIndices(draw_packet.indices);
+					}
+					draw(effect_ptr, draw_packet.texture, draw_packet.topology, mMesh, vertex_count, index_count);
+				}
+
+				pop();
+			},
+			[&](const ClearPacket& clear_packet) {
+				push(clear_packet.state);
+				clear(clear_packet.color, clear_packet.depth, clear_packet.stencil);
+				pop();
+			}
+		}, packet);
+	}
+
+	mContext.batches_count += list.mContext.batches_count;
+}
+
+bool System::CommandList::isSingleTarget(const std::shared_ptr<skygfx::RenderTarget>& target) const
+{
+	for (const auto& packet : mContext.packets)
+	{
+		auto same = std::visit([&](const auto& value) {
+			return value.state.render_target == target;
+		}, packet);
+
+		if (!same)
+			return false;
+	}
+
+	return true;
+}
+
+bool System::CommandList::hasExternalMeshes() const
+{
+	for (const auto& packet : mContext.packets)
+	{
+		if (auto draw = std::get_if<DrawPacket>(&packet); draw != nullptr && draw->mesh != nullptr)
+			return true;
+	}
+
+	return false;
 }
 
 bool System::isSameBatch(const State& left, const State& right)
@@ -70,45 +253,82 @@ bool System::isSameBatch(const State& left, const State& right)
 
 void System::applyState()
 {
-	assert(!mStates.empty());
+	auto& context = getContext();
+
+	assert(!context.states.empty());
 
-	const auto& state = mStates.top();
+	const auto& state = context.states.top();
 
-	if (mAppliedState.has_value() && isSameBatch(mAppliedState.value(), state))
+	if (context.applied_state.has_value() && isSameBatch(context.applied_state.value(), state))
 		return;
 
 	flushBatch();
 
+	if (context.deferred)
+	{
+		context.applied_state = state;
+		return;
+	}
+
 	bool renderTargetChanged = true;
 
-	if (mAppliedState.has_value())
+	if (context.applied_state.has_value())
 	{
-		const auto& applied_state = mAppliedState.value();
+		const auto& applied_state = context.applied_state.value();
 		renderTargetChanged = applied_state.render_target != state.render_target;
 	}
 
 	if (renderTargetChanged)
 		RENDERER->setRenderTarget(state.render_target);
 
-	mAppliedState = state;
+	if (RENDERER->isHeadless())
+		RENDERER->getRecorder()->stateChanged();
+
+	context.applied_state = state;
 }
 
 void System::flushBatch()
 {
-	if (mBatch.vertices.empty())
+	auto& context = getContext();
+	auto& batch = context.batch;
+
+	if (batch.vertices.empty())
 		return;
 
-	mFlushCount += 1;
+	context.flush_count += 1;
 
-	assert(mAppliedState.has_value());
+	assert(context.applied_state.has_value());
 
-	mBatch.mesh.setVertices(mBatch.vertices);
-	mBatch.mesh.setIndices(mBatch.indices);
+	if (context.deferred)
+	{
+		context.packets.push_back(BatchPacket{
+			.state = context.applied_state.value(),
+			.texture = batch.texture,
+			.topology = batch.topology.value(),
+			.vertices = std::move(batch.vertices),
+			.indices = std::move(batch.indices)
+		});
+		batch.vertices.clear();
+		batch.indices.clear();
+		return;
+	}
+
+	// glyphs rasterized since last flush should reach font pages before they are sampled
+	Font::UploadPending();
+
+	auto vertex_count = static_cast<uint32_t>(batch.vertices.size());
+	auto index_count = static_cast<uint32_t>(batch.indices.size());
+
+	if (!RENDERER->isHeadless())
+	{
+		batch.mesh.setVertices(batch.vertices);
+		batch.mesh.setIndices(batch.indices);
+	}
 
-	mBatch.vertices.clear();
-	mBatch.indices.clear();
+	batch.vertices.clear();
+	batch.indices.clear();
 
-	const auto& state = mAppliedState.value();
+	const auto& state = context.applied_state.value();
 
 	float width;
 	float height;
@@ -139,8 +359,8 @@ void System::flushBatch()
 		.height = static_cast<uint32_t>(height)
 	});
 
-	skygfx::utils::ExecuteCommands({
-		skygfx::utils::commands::SetTopology(mBatch.topology.value()),
+	RENDERER->execute({
+		skygfx::utils::commands::SetTopology(batch.topology.value()),
 		skygfx::utils::commands::SetProjectionMatrix(proj),
 		skygfx::utils::commands::SetViewMatrix(view),
 		skygfx::utils::commands::SetViewport(state.viewport),
@@ -152,25 +372,52 @@ void System::flushBatch()
 		skygfx::utils::commands::SetSampler(state.sampler),
 		skygfx::utils::commands::SetTextureAddress(state.texture_address),
 		skygfx::utils::commands::SetMipmapBias(state.mipmap_bias),
-		skygfx::utils::commands::SetMesh(&mBatch.mesh),
-		skygfx::utils::commands::SetColorTexture(mBatch.texture ? mBatch.texture.get() : nullptr),
+		skygfx::utils::commands::SetMesh(&batch.mesh),
+		skygfx::utils::commands::SetColorTexture(batch.texture ? batch.texture.get() : nullptr),
 		skygfx::utils::commands::DrawMesh()
-	});
+	}, vertex_count, index_count);
 }
 
 void System::clear(std::optional<glm::vec4> color, std::optional<float> depth, std::optional<uint8_t> stencil)
 {
 	applyState();
+
+	auto& context = getContext();
+
+	if (context.deferred)
+	{
+		context.packets.push_back(ClearPacket{
+			.state = context.states.top(),
+			.color = color,
+			.depth = depth,
+			.stencil = stencil
+		});
+		return;
+	}
+
 	RENDERER->clear(color, depth, stencil);
 }
 
 void System::draw(sky::effects::IEffect* effect, skygfx::Texture* texture, skygfx::Topology topology,
 	const skygfx::utils::Mesh& mesh)
+{
+	draw(effect, texture, topology, mesh, mesh.getVertexCount(), mesh.getIndexCount());
+}
+
+void System::draw(sky::effects::IEffect* effect, skygfx::Texture* texture, skygfx::Topology topology,
+	const skygfx::utils::Mesh& mesh, uint32_t vertex_count, uint32_t index_count)
 {
 	applyState();
 	flushBatch();
 
-	const auto& state = mStates.top();
+	auto& context = getContext();
+	const auto& state = context.states.top();
+
+	if (context.deferred)
+	{
+		recordDraw(effect, texture, topology).mesh = &mesh; // should be alive until submit
+		return;
+	}
 
 	std::vector<skygfx::utils::Command> cmds;
 
@@ -198,46 +445,113 @@ void System::draw(sky::effects::IEffect* effect, skygfx::Texture* texture, skygf
 		skygfx::utils::commands::DrawMesh()
 	});
 
-	skygfx::utils::ExecuteCommands(cmds);
+	RENDERER->execute(cmds, vertex_count, index_count);
+}
+
+System::DrawPacket& System::recordDraw(sky::effects::IEffect* effect, skygfx::Texture* texture,
+	skygfx::Topology topology)
+{
+	auto& context = getContext();
+	assert(context.deferred);
+
+	auto& packet = std::get<DrawPacket>(context.packets.emplace_back(DrawPacket{
+		.state = context.states.top(),
+		.texture = texture,
+		.topology = topology
+	}));
+
+	if (effect != nullptr)
+	{
+		auto data = (uint8_t*)effect->getUniformData();
+		packet.has_effect = true;
+		packet.shader = effect->getShader();
+		packet.uniform_binding = effect->getUniformBinding();
+		packet.uniform_data.assign(data, data + effect->getUniformSize());
+	}
+
+	return packet;
 }
 
 void System::draw(sky::effects::IEffect* effect, std::shared_ptr<skygfx::Texture> texture,
 	skygfx::Topology topology, skygfx::utils::Mesh::Vertex* vertices, uint32_t vertex_count,
 	skygfx::utils::Mesh::Index* indices, uint32_t index_count)
 {
-	if (!mBatching || vertex_count > 40 || effect != nullptr)
+	auto& context = getContext();
+
+	if (!mBatching || vertex_count > MaxBatchedVertexCount || effect != nullptr)
 	{
-		mMesh.setVertices(vertices, vertex_count);
-		mMesh.setIndices(indices, index_count);
-		draw(effect, texture ? texture.get() : nullptr, topology, mMesh);
+		if (context.deferred)
+		{
+			// shared mMesh cannot be touched from recording thread, packet owns a copy of vertices
+			applyState();
+			flushBatch();
+			auto& packet = recordDraw(effect, texture ? texture.get() : nullptr, topology);
+			packet.vertices.assign(vertices, vertices + vertex_count);
+			packet.indices.assign(indices, indices + index_count);
+			return;
+		}
+		if (!RENDERER->isHeadless())
+		{
+			mMesh.setVertices(vertices, vertex_count);
+			mMesh.setIndices(indices, index_count);
+		}
+		draw(effect, texture ? texture.get() : nullptr, topology, mMesh, vertex_count, index_count);
 		return;
 	}
 
+	auto batch_texture = texture;
+	auto uv_offset = glm::vec2{ 0.0f, 0.0f };
+	auto uv_scale = glm::vec2{ 1.0f, 1.0f };
+
+	if (mTexturePaging && texture != nullptr && !context.deferred && !mCopyingToPage)
+	{
+		const auto& state = context.states.top();
+
+		auto placement = state.texture_address == skygfx::TextureAddress::Clamp && state.mipmap_bias == 0.0f ?
+			getTexturePlacement(texture.get()) : nullptr;
+
+		// remapping is possible only when sampling stays inside of texture,
+		// texcoords are scanned only for textures that are actually in pages
+		auto inside = placement != nullptr && std::all_of(vertices, vertices + vertex_count, [](const auto& vertex) {
+			return glm::all(glm::greaterThanEqual(vertex.texcoord, glm::vec2(0.0f))) &&
+				glm::all(glm::lessThanEqual(vertex.texcoord, glm::vec2(1.0f)));
+		});
+
+		if (inside)
+		{
+			batch_texture = mTexturePages.getPages().at(placement->page.value()).target;
+			uv_offset = placement->uv_offset;
+			uv_scale = placement->uv_scale;
+		}
+	}
+
 	applyState();
 
-	if (mBatch.topology != topology || mBatch.texture != texture)
+	auto& batch = context.batch;
+
+	if (batch.topology != topology || batch.texture != batch_texture)
 		flushBatch();
 
-	mBatchesCount += 1;
+	context.batches_count += 1;
 
-	mBatch.texture = texture;
-	mBatch.topology = topology;
+	batch.texture = batch_texture;
+	batch.topology = topology;
 
 	for (uint32_t i = 0; i < vertex_count; i++)
 	{
 		const auto& vertex = vertices[i];
 		auto projected_pos = project(vertex.pos);
-		mBatch.vertices.push_back(skygfx::utils::Mesh::Vertex{
+		batch.vertices.push_back(skygfx::utils::Mesh::Vertex{
 			.pos = projected_pos,
 			.color = vertex.color,
-			.texcoord = vertex.texcoord
+			.texcoord = (vertex.texcoord * uv_scale) + uv_offset
 		});
 	}
 
 	for (uint32_t i = 0; i < index_count; i++)
 	{
 		auto index = indices[i];
-		mBatch.indices.push_back(static_cast<uint32_t>(mBatch.vertices.size() - vertex_count) + index);
+		batch.indices.push_back(static_cast<uint32_t>(batch.vertices.size() - vertex_count) + index);
 	}
 }
 
@@ -253,23 +567,177 @@ void System::draw(sky::effects::IEffect* effect, std::shared_ptr<skygfx::Texture
 	draw(effect, texture, topology, vertices, vertex_count, indices, index_count);
 }
 
-void System::draw(sky::effects::IEffect* effect, std::shared_ptr<skygfx::Texture> texture,
-	skygfx::utils::MeshBuilder::Mode mode,
-	std::function<void(std::function<void(const skygfx::utils::Mesh::Vertex&)>)> callback)
+// list topologies only, so emitted primitives can be merged into one batch
+
+static std::optional<skygfx::Topology> GetEmittedTopology(skygfx::utils::MeshBuilder::Mode mode)
 {
-	mMeshBuilder.reset();
-	mMeshBuilder.begin(mode);
-	callback([&](const skygfx::utils::Mesh::Vertex& vertex) {
-		mMeshBuilder.vertex(vertex);
+	using Mode = skygfx::utils::MeshBuilder::Mode;
+
+	if (mode == Mode::Lines || mode == Mode::LineLoop)
+		return skygfx::Topology::LineList;
+
+	if (mode == Mode::Triangles || mode == Mode::TriangleStrip || mode == Mode::TriangleFan)
+		return skygfx::Topology::TriangleList;
+
+	return std::nullopt;
+}
+
+static void AppendEmittedIndices(skygfx::utils::MeshBuilder::Mode mode, uint32_t base, uint32_t count,
+	skygfx::utils::Mesh::Indices& indices)
+{
+	using Mode = skygfx::utils::MeshBuilder::Mode;
+
+	if (mode == Mode::Lines || mode == Mode::Triangles)
+	{
+		for (uint32_t i = 0; i < count; i++)
+		{
+			indices.push_back(base + i);
+		}
+	}
+	else if (mode == Mode::LineLoop)
+	{
+		for (uint32_t i = 0; count > 1 && i < count; i++)
+		{
+			indices.push_back(base + i);
+			indices.push_back(base + ((i + 1) % count));
+		}
+	}
+	else if (mode == Mode::TriangleStrip)
+	{
+		for (uint32_t i = 2; i < count; i++)
+		{
+			bool even = i % 2 == 0;
+			indices.push_back(base + (even ? i - 2 : i - 1));
+			indices.push_back(base + (even ? i - 1 : i - 2));
+			indices.push_back(base + i);
+		}
+	}
+	else if (mode == Mode::TriangleFan)
+	{
+		for (uint32_t i = 2; i < count; i++)
+		{
+			indices.push_back(base);
+			indices.push_back(base + i - 1);
+			indices.push_back(base + i);
+		}
+	}
+}
+
+void System::drawEmitted(sky::effects::IEffect* effect, std::shared_ptr<skygfx::Texture> texture,
+	skygfx::utils::MeshBuilder::Mode mode)
+{
+	auto& context = getContext();
+	const auto& vertices = context.emit_vertices;
+	auto& indices = context.emit_indices;
+	auto count = static_cast<uint32_t>(vertices.size());
+	auto topology = GetEmittedTopology(mode);
+
+	if (topology.has_value())
+	{
+		indices.clear();
+		AppendEmittedIndices(mode, 0, count, indices);
+		draw(effect, texture, topology.value(), vertices, indices);
+		return;
+	}
+
+	auto& mesh_builder = context.mesh_builder;
+	mesh_builder.reset();
+	mesh_builder.begin(mode);
+	for (const auto& vertex : vertices)
+	{
+		mesh_builder.vertex(vertex);
+	}
+	mesh_builder.end();
+	assert(!mesh_builder.isBegan());
+
+	draw(effect, texture, mesh_builder.getTopology().value(), mesh_builder.getVertices(), mesh_builder.getIndices());
+}
+
+skygfx::utils::Mesh::Vertices* System::beginEmitToBatch(const std::shared_ptr<skygfx::Texture>& texture,
+	skygfx::utils::MeshBuilder::Mode mode)
+{
+	auto topology = GetEmittedTopology(mode);
+
+	if (!mBatching || !topology.has_value())
+		return nullptr;
+
+	auto& context = getContext();
+	auto batch_texture = texture;
+
+	if (mTexturePaging && texture != nullptr && !context.deferred && !mCopyingToPage)
+	{
+		const auto& state = context.states.top();
+
+		// texcoords are checked when vertices are emitted, draw goes through scratch when they leave texture
+		auto placement = state.texture_address == skygfx::TextureAddress::Clamp && state.mipmap_bias == 0.0f ?
+			getTexturePlacement(texture.get()) : nullptr;
+
+		if (placement != nullptr)
+			batch_texture = mTexturePages.getPages().at(placement->page.value()).target;
+	}
+
+	applyState();
+
+	auto& batch = context.batch;
+
+	if (batch.topology != topology || batch.texture != batch_texture)
+		flushBatch();
+
+	batch.texture = batch_texture;
+	batch.topology = topology;
+
+	return &batch.vertices;
+}
+
+void System::endEmitToBatch(std::shared_ptr<skygfx::Texture> texture, skygfx::utils::MeshBuilder::Mode mode,
+	size_t first)
+{
+	auto& context = getContext();
+	auto& batch = context.batch;
+	auto begin = batch.vertices.begin() + first;
+	auto count = static_cast<uint32_t>(batch.vertices.size() - first);
+	auto remapped = batch.texture != texture;
+
+	auto inside = !remapped || std::all_of(begin, batch.vertices.end(), [](const auto& vertex) {
+		return glm::all(glm::greaterThanEqual(vertex.texcoord, glm::vec2(0.0f))) &&
+			glm::all(glm::lessThanEqual(vertex.texcoord, glm::vec2(1.0f)));
 	});
-	mMeshBuilder.end();
-	assert(!mMeshBuilder.isBegan());
 
-	auto topology = mMeshBuilder.getTopology().value();
-	const auto& vertices = mMeshBuilder.getVertices();
-	const auto& indices = mMeshBuilder.getIndices();
+	if (count > MaxBatchedVertexCount || !inside)
+	{
+		// rare large or tiled draws take the scratch way
+		context.emit_vertices.assign(begin, batch.vertices.end());
+		batch.vertices.resize(first);
+		drawEmitted(nullptr, std::move(texture), mode);
+		return;
+	}
+
+	auto index_count = batch.indices.size();
+	AppendEmittedIndices(mode, static_cast<uint32_t>(first), count, batch.indices);
+
+	if (batch.indices.size() == index_count)
+	{
+		batch.vertices.resize(first); // nothing to draw
+		return;
+	}
 
-	draw(effect, texture, topology, vertices, indices);
+	context.batches_count += 1;
+
+	auto uv_offset = glm::vec2{ 0.0f, 0.0f };
+	auto uv_scale = glm::vec2{ 1.0f, 1.0f };
+
+	if (remapped)
+	{
+		auto placement = getTexturePlacement(texture.get());
+		uv_offset = placement->uv_offset;
+		uv_scale = placement->uv_scale;
+	}
+
+	for (auto it = batch.vertices.begin() + first; it != batch.vertices.end(); ++it)
+	{
+		it->pos = project(it->pos);
+		it->texcoord = (it->texcoord * uv_scale) + uv_offset;
+	}
 }
 
 void System::drawTexturedRectangle(sky::effects::IEffect* effect, std::shared_ptr<skygfx::Texture> texture,
@@ -278,12 +746,17 @@ void System::drawTexturedRectangle(sky::effects::IEffect* effect, std::shared_pt
 	const glm::vec4& top_left_color, const glm::vec4& top_right_color,
 	const glm::vec4& bottom_left_color, const glm::vec4& bottom_right_color)
 {
-	draw(effect, texture, skygfx::utils::MeshBuilder::Mode::TriangleStrip, [&](auto vertex) {
-		vertex({ .pos = { 0.0f, 0.0f, 0.0f }, .color = top_left_color, .texcoord = top_left_uv });
-		vertex({ .pos = { 0.0f, 1.0f, 0.0f }, .color = bottom_left_color, .texcoord = bottom_left_uv });
-		vertex({ .pos = { 1.0f, 0.0f, 0.0f }, .color = top_right_color, .texcoord = top_right_uv });
-		vertex({ .pos = { 1.0f, 1.0f, 0.0f }, .color = bottom_right_color, .texcoord = bottom_right_uv });
-	});
+	// same triangles as a four vertex strip, without going through emitter
+	skygfx::utils::Mesh::Vertex vertices[4] = {
+		{ .pos = { 0.0f, 0.0f, 0.0f }, .color = top_left_color, .texcoord = top_left_uv },
+		{ .pos = { 0.0f, 1.0f, 0.0f }, .color = bottom_left_color, .texcoord = bottom_left_uv },
+		{ .pos = { 1.0f, 0.0f, 0.0f }, .color = top_right_color, .texcoord = top_right_uv },
+		{ .pos = { 1.0f, 1.0f, 0.0f }, .color = bottom_right_color, .texcoord = bottom_right_uv }
+	};
+
+	static skygfx::utils::Mesh::Index indices[6] = { 0, 1, 2, 2, 1, 3 };
+
+	draw(effect, texture, skygfx::Topology::TriangleList, vertices, 4, indices, 6);
 }
 
 void System::drawTexturedRectangle(sky::effects::IEffect* effect, std::shared_ptr<skygfx::Texture> texture,
@@ -324,16 +797,17 @@ void System::drawRoundedRectangle(const glm::vec4& top_left_color, const glm::ve
 	const glm::vec4& bottom_left_color, const glm::vec4& bottom_right_color, const glm::vec2& size,
 	float rounding, bool absolute_rounding)
 {
-	mRoundedEffect.uniform.size = size;
+	auto& rounded_effect = getContext().rounded_effect;
+	rounded_effect.uniform.size = size;
 	if (absolute_rounding)
 	{
-		mRoundedEffect.uniform.radius = glm::clamp(rounding, 0.0f, glm::min(size.x, size.y) / 2.0f);
+		rounded_effect.uniform.radius = glm::clamp(rounding, 0.0f, glm::min(size.x, size.y) / 2.0f);
 	}
 	else
 	{
-		mRoundedEffect.uniform.radius = (glm::clamp(rounding, 0.0f, 1.0f) * glm::min(size.x, size.y)) / 2.0f;
+		rounded_effect.uniform.radius = (glm::clamp(rounding, 0.0f, 1.0f) * glm::min(size.x, size.y)) / 2.0f;
 	}
-	drawRectangle(&mRoundedEffect, top_left_color, top_right_color, bottom_left_color, bottom_right_color);
+	drawRectangle(&rounded_effect, top_left_color, top_right_color, bottom_left_color, bottom_right_color);
 }
 
 void System::drawRoundedRectangle(const glm::vec4& color,
@@ -345,6 +819,12 @@ void System::drawRoundedRectangle(const glm::vec4& color,
 void System::drawRoundedSlicedRectangle(const glm::vec4& color,
 	const glm::vec2& size, float rounding, bool absolute_rounding)
 {
+	if (mWhiteCircleTexture == nullptr)
+	{
+		drawRoundedRectangle(color, size, rounding, absolute_rounding);
+		return;
+	}
+
 	glm::vec2 region_pos = { (mWhiteCircleTexture->getWidth() / 2.0f) - 1.0f, (mWhiteCircleTexture->getHeight() / 2.0f) - 1.0f };
 	glm::vec2 region_size = { 2.0f, 2.0f };
 	auto center_region = Graphics::TexRegion(region_pos, region_size);
@@ -370,11 +850,12 @@ void System::drawLineRectangle(const glm::vec4& color)
 void System::drawCircle(const glm::vec4& inner_color, const glm::vec4& outer_color,
 	float fill, float pie)
 {
-	mCircleEffect.uniform.fill = fill;
-	mCircleEffect.uniform.pie = pie;
-	mCircleEffect.uniform.inner_color = inner_color;
-	mCircleEffect.uniform.outer_color = outer_color;
-	drawRectangle(&mCircleEffect);
+	auto& circle_effect = getContext().circle_effect;
+	circle_effect.uniform.fill = fill;
+	circle_effect.uniform.pie = pie;
+	circle_effect.uniform.inner_color = inner_color;
+	circle_effect.uniform.outer_color = outer_color;
+	drawRectangle(&circle_effect);
 }
 
 void System::drawSegmentedCircle(int segments, const glm::vec4& inner_color,
@@ -432,6 +913,12 @@ void System::drawSegmentedCircle(int segments, const glm::vec4& inner_color,
 
 void System::drawCircleTexture(const glm::vec4& color)
 {
+	if (mWhiteCircleTexture == nullptr)
+	{
+		drawCircle(color, color);
+		return;
+	}
+
 	pushSampler(skygfx::Sampler::Linear);
 	drawTexturedRectangle(nullptr, mWhiteCircleTexture, {}, color, color, color, color);
 	pop();
@@ -455,7 +942,7 @@ void System::drawSlicedSprite(sky::effects::IEffect* effect, std::shared_ptr<sky
 		p2 = (size - edge_size.value()) / size;
 	}
 
-	static auto vertices = skygfx::utils::Mesh::Vertices(36);
+	static thread_local auto vertices = skygfx::utils::Mesh::Vertices(36);
 
 	// top left
 
@@ -542,29 +1029,63 @@ void System::drawSdf(skygfx::Topology topology, std::shared_ptr<skygfx::Texture>
 	assert(!vertices.empty());
 	assert(!indices.empty());
 
-	mSdfEffect.uniform.min_value = minValue;
-	mSdfEffect.uniform.max_value = maxValue;
-	mSdfEffect.uniform.smooth_factor = smoothFactor;
-	mSdfEffect.uniform.color = color;
+	auto& sdf_effect = getContext().sdf_effect;
+	sdf_effect.uniform.min_value = minValue;
+	sdf_effect.uniform.max_value = maxValue;
+	sdf_effect.uniform.smooth_factor = smoothFactor;
+	sdf_effect.uniform.color = color;
 
-	draw(&mSdfEffect, texture, topology, vertices, indices);
+	draw(&sdf_effect, texture, topology, vertices, indices);
 }
 
 void System::drawString(const Font& font, const sky::TextMesh& mesh, float minValue, float maxValue,
 	float smoothFactor, const glm::vec4& color)
 {
-	assert(!mesh.getVertices().empty());
-	assert(!mesh.getIndices().empty());
+	assert(!mesh.getGlyphs().empty());
+
+	// new pages get their textures here, recording threads rely on upload made before recording
+	if (!isRecordingCommandList())
+		Font::UploadPending();
+
+	auto& context = getContext();
+
+	auto& sdf_effect = context.sdf_effect;
+	sdf_effect.uniform.min_value = minValue;
+	sdf_effect.uniform.max_value = maxValue;
+	sdf_effect.uniform.smooth_factor = smoothFactor;
+	sdf_effect.uniform.color = color;
+
+	const auto& glyphs = mesh.getGlyphs();
 
-	drawSdf(mesh.getTopology(), font.getTexture(), mesh.getVertices(), mesh.getIndices(), minValue,
-		maxValue, smoothFactor, color);
+	for (auto page : mesh.getPages())
+	{
+		auto texture = font.getTexture(page);
+
+		if (context.deferred)
+		{
+			// packet keeps compact glyphs, quads are built on replay
+			applyState();
+			flushBatch();
+			auto& packet = recordDraw(&sdf_effect, texture.get(), sky::TextMesh::Topology);
+			std::copy_if(glyphs.begin(), glyphs.end(), std::back_inserter(packet.glyphs), [&](const auto& glyph) {
+				return glyph.page == page;
+			});
+			continue;
+		}
+
+		auto& vertices = context.glyph_vertices;
+		auto& indices = context.glyph_indices;
+		vertices.clear();
+		indices.clear();
+		sky::TextMesh::AppendQuads(glyphs.data(), glyphs.size(), page, vertices, indices);
+		draw(&sdf_effect, texture, sky::TextMesh::Topology, vertices, indices);
+	}
 }
 
 void System::drawString(const Font& font, const sky::TextMesh& mesh, float bold,
 	const glm::vec4& color, float outlineThickness, const glm::vec4& outlineColor)
 {
-	assert(!mesh.getVertices().empty());
-	assert(!mesh.getIndices().empty());
+	assert(!mesh.getGlyphs().empty());
 
 	float fixedOutlineThickness = glm::lerp(0.0f, 0.75f, outlineThickness);
 
@@ -629,18 +1150,20 @@ glm::vec3 System::project(const glm::vec3& pos)
 
 void System::push(const State& value)
 {
-	assert(mWorking);
-	mStates.push(value);
+	auto& context = getContext();
+	assert(context.working);
+	context.states.push(value);
 }
 
 void System::pop(int count)
 {
-	assert(mWorking);
-	assert(mStates.size() >= count);
+	auto& context = getContext();
+	assert(context.working);
+	assert(context.states.size() >= count);
 
 	for (int i = 0; i < count; i++)
 	{
-		mStates.pop();
+		context.states.pop();
 	}
 }
 
@@ -651,49 +1174,49 @@ void System::pushCleanState()
 
 void System::pushSampler(skygfx::Sampler value)
 {
-	auto state = mStates.top();
+	auto state = getCurrentState();
 	state.sampler = value;
 	push(state);
 }
 
 void System::pushBlendMode(skygfx::BlendMode value)
 {
-	auto state = mStates.top();
+	auto state = getCurrentState();
 	state.blend_mode = value;
 	push(state);
 }
 
 void System::pushDepthMode(std::optional<skygfx::DepthMode> value)
 {
-	auto state = mStates.top();
+	auto state = getCurrentState();
 	state.depth_mode = value;
 	push(state);
 }
 
 void System::pushCullMode(skygfx::CullMode value)
 {
-	auto state = mStates.top();
+	auto state = getCurrentState();
 	state.cull_mode = value;
 	push(state);
 }
 
 void System::pushViewport(std::optional<skygfx::Viewport> value)
 {
-	auto state = mStates.top();
+	auto state = getCurrentState();
 	state.viewport = value;
 	push(state);
 }
 
 void System::pushRenderTarget(std::shared_ptr<skygfx::RenderTarget> value)
 {
-	auto state = mStates.top();
+	auto state = getCurrentState();
 	state.render_target = value;
 	push(state);
 }
 
 void System::pushScissor(std::optional<skygfx::Scissor> value, bool inherit_prev_scissor)
 {
-	auto state = mStates.top();
+	auto state = getCurrentState();
 	if (inherit_prev_scissor && state.scissor.has_value())
 	{
 		if (value.has_value())
@@ -722,28 +1245,28 @@ void System::pushScissor(std::optional<skygfx::Scissor> value, bool inherit_prev
 
 void System::pushViewMatrix(const glm::mat4& value)
 {
-	auto state = mStates.top();
+	auto state = getCurrentState();
 	state.view_matrix = value;
 	push(state);
 }
 
 void System::pushProjectionMatrix(const glm::mat4& value)
 {
-	auto state = mStates.top();
+	auto state = getCurrentState();
 	state.projection_matrix = value;
 	push(state);
 }
 
 void System::pushModelMatrix(const glm::mat4& value)
 {
-	auto state = mStates.top();
+	auto state = getCurrentState();
 	state.model_matrix = value;
 	push(state);
 }
 
 void System::pushTextureAddress(skygfx::TextureAddress value)
 {
-	auto state = mStates.top();
+	auto state = getCurrentState();
 	state.texture_address = value;
 	push(state);
 }
@@ -763,14 +1286,14 @@ void System::pushOrthoMatrix(std::shared_ptr<skygfx::RenderTarget> target)
 
 void System::pushStencilMode(std::optional<skygfx::StencilMode> value)
 {
-	auto state = mStates.top();
+	auto state = getCurrentState();
 	state.stencil_mode = value;
 	push(state);
 }
 
 void System::pushMipmapBias(float bias)
 {
-	auto state = mStates.top();
+	auto state = getCurrentState();
 	state.mipmap_bias = bias;
 	push(state);
 }
@@ -783,39 +1306,97 @@ void System::setBatching(bool value)
 	mBatching = value;
 }
 
-std::shared_ptr<skygfx::RenderTarget> System::getRenderTarget(const std::string& name, uint32_t width, uint32_t height)
+std::shared_ptr<skygfx::RenderTarget> System::getRenderTarget(uint32_t width, uint32_t height, skygfx::PixelFormat format)
 {
-	if (mRenderTargets.contains(name))
-	{
-		auto target = mRenderTargets.at(name);
+	assert(!isRecordingCommandList());
+	return mRenderTargetPool.acquire(width, height, format);
+}
 
-		if (target->getWidth() != width || target->getHeight() != height)
-		{
-			mRenderTargets.erase(name);
-		}
-	}
+std::shared_ptr<skygfx::RenderTarget> System::getRenderTarget()
+{
+	return getRenderTarget(PLATFORM->getWidth(), PLATFORM->getHeight());
+}
 
-	if (!mRenderTargets.contains(name))
-	{
-		auto target = std::make_shared<skygfx::RenderTarget>(width, height);
-		mRenderTargets.insert({ name, target });
-	}
+void System::addPageableTexture(std::shared_ptr<skygfx::Texture> texture)
+{
+	mTexturePages.add(texture);
+}
 
-	mUnusedRenderTargets.erase(name);
+void System::setTexturePaging(bool value)
+{
+	if (!value && mTexturePaging)
+		flushBatch();
 
-	return mRenderTargets.at(name);
+	mTexturePaging = value;
 }
 
-std::shared_ptr<skygfx::RenderTarget> System::getRenderTarget(const std::string& name)
+const TexturePages::Placement* System::getTexturePlacement(skygfx::Texture* texture)
 {
-	return getRenderTarget(name, PLATFORM->getWidth(), PLATFORM->getHeight());
+	if (RENDERER->isHeadless())
+		return nullptr;
+
+	auto placement = mTexturePages.find(texture);
+
+	if (placement == nullptr || placement->rejected)
+		return nullptr;
+
+	if (placement->page.has_value())
+		return placement;
+
+	auto width = texture->getWidth();
+	auto height = texture->getHeight();
+
+	if (!mTexturePages.allocate(*placement, width, height))
+	{
+		placement->rejected = true;
+		return nullptr;
+	}
+
+	auto& page = mTexturePages.getPages().at(placement->page.value());
+	auto source = placement->texture.lock();
+
+	if (page.target == nullptr)
+		page.target = std::make_shared<skygfx::RenderTarget>(TexturePages::PageSize, TexturePages::PageSize,
+			skygfx::PixelFormat::RGBA8UNorm);
+
+	// copy with clamped texcoords outside of texture, so padding repeats edge pixels
+	auto padding = (float)TexturePages::Padding;
+	auto pos = glm::vec2(placement->pos) - padding;
+	auto size = glm::vec2{ (float)width, (float)height } + (padding * 2.0f);
+	auto uv_min = -padding / glm::vec2{ (float)width, (float)height };
+	auto uv_max = 1.0f - uv_min;
+
+	mCopyingToPage = true;
+	pushCleanState();
+	pushRenderTarget(page.target);
+	pushOrthoMatrix(page.target);
+	if (page.dirty)
+	{
+		clear();
+		page.dirty = false;
+	}
+	pushModelMatrix(glm::scale(glm::translate(glm::mat4(1.0f), { pos, 0.0f }), { size, 1.0f }));
+	pushBlendMode(skygfx::BlendStates::Opaque);
+	pushSampler(skygfx::Sampler::Nearest);
+	pushTextureAddress(skygfx::TextureAddress::Clamp);
+	drawTexturedRectangle(nullptr, source, uv_min, { uv_max.x, uv_min.y }, { uv_min.x, uv_max.y }, uv_max,
+		glm::vec4(1.0f), glm::vec4(1.0f), glm::vec4(1.0f), glm::vec4(1.0f));
+	pop(7);
+	mCopyingToPage = false;
+
+	return placement;
 }
 
 std::shared_ptr<skygfx::Texture> System::makeGenericTexture(const glm::ivec2& size, std::function<void()> callback)
 {
+	assert(!isRecordingCommandList());
+
+	if (RENDERER->isHeadless())
+		return nullptr;
+
 	auto result = std::make_shared<skygfx::RenderTarget>(size.x, size.y);
 
-	auto working = mWorking;
+	auto working = mContext.working;
 
 	if (!working)
 		begin();
@@ -8,6 +8,8 @@
 #include <graphics/font.h>
 #include <graphics/tex_region.h>
 #include <graphics/effects.h>
+#include <graphics/render_target_pool.h>
+#include <graphics/texture_pages.h>
 
 #include <glm/glm.hpp>
 #include <glm/ext.hpp>
@@ -15,6 +17,7 @@
 #include <stack>
 #include <sky/text_mesh.h>
 #include <set>
+#include <variant>
 
 #define GRAPHICS sky::Locator<Graphics::System>::Get()
 
@@ -51,9 +54,10 @@ namespace Graphics
 			skygfx::Topology topology, const skygfx::utils::Mesh::Vertices& vertices,
 			const skygfx::utils::Mesh::Indices& indices);
 
+		// callback receives vertex sink, geometry goes to reusable per-context buffers without type erasure
+		template <typename Callback>
 		void draw(sky::effects::IEffect* effect, std::shared_ptr<skygfx::Texture> texture,
-			skygfx::utils::MeshBuilder::Mode mode,
-			std::function<void(std::function<void(const skygfx::utils::Mesh::Vertex&)>)> callback);
+			skygfx::utils::MeshBuilder::Mode mode, Callback&& callback);
 
 		// colored rectangle
 		void drawTexturedRectangle(sky::effects::IEffect* effect, std::shared_ptr<skygfx::Texture> texture,
@@ -139,7 +143,7 @@ namespace Graphics
 		void pushStencilMode(std::optional<skygfx::StencilMode> value);
 		void pushMipmapBias(float bias);
 
-		const auto& getCurrentState() const { return mStates.top(); }
+		const auto& getCurrentState() const { return getContext().states.top(); }
 
 	public:
 		struct State
@@ -157,14 +161,40 @@ namespace Graphics
 			skygfx::TextureAddress texture_address = skygfx::TextureAddress::Clamp;
 			std::optional<skygfx::StencilMode> stencil_mode = std::nullopt;
 			float mipmap_bias = 0.0f;
+
+			bool operator==(const State& other) const = default;
 		};
 
-	private:
-		bool mWorking = false;
+	public:
+		class CommandList;
+
+		// command lists are recorded on worker threads and submitted in order on the main thread,
+		// recording thread gets its own state stack and batch, nothing reaches the renderer until submit
+
+		void beginCommandList(CommandList& list, const State& state);
+		void endCommandList();
+		void submit(CommandList& list);
+		void replay(const CommandList& list); // same as submit, but packets are kept for next replay
+		bool isRecordingCommandList() const;
 
 	private:
-		std::stack<State> mStates;
-		std::optional<State> mAppliedState;
+		struct DrawPacket;
+
+		void draw(sky::effects::IEffect* effect, skygfx::Texture* texture, skygfx::Topology topology,
+			const skygfx::utils::Mesh& mesh, uint32_t vertex_count, uint32_t index_count);
+		DrawPacket& recordDraw(sky::effects::IEffect* effect, skygfx::Texture* texture, skygfx::Topology topology);
+		void drawEmitted(sky::effects::IEffect* effect, std::shared_ptr<skygfx::Texture> texture,
+			skygfx::utils::MeshBuilder::Mode mode);
+
+		// batchable emitted draws write vertices straight to batch, returns nullptr when draw
+		// should be emitted to scratch, emitter callback must not draw anything by itself
+		skygfx::utils::Mesh::Vertices* beginEmitToBatch(const std::shared_ptr<skygfx::Texture>& texture,
+			skygfx::utils::MeshBuilder::Mode mode);
+		void endEmitToBatch(std::shared_ptr<skygfx::Texture> texture, skygfx::utils::MeshBuilder::Mode mode,
+			size_t first);
+
+	public:
+		static constexpr uint32_t MaxBatchedVertexCount = 40; // larger draws go to gpu on their own
 
 	public:
 		bool isBatching() const { return mBatching; }
@@ -175,45 +205,167 @@ namespace Graphics
 
 	private:
 		bool mBatching = true;
-		int mBatchesCount = 0;
 		int mBatchesCountPublic = 0;
-		int mFlushCount = 0;
 		int mFlushCountPublic = 0;
 
 	private:
-		struct
+		struct BatchPacket
 		{
+			State state;
 			std::shared_ptr<skygfx::Texture> texture;
-			std::optional<skygfx::Topology> topology;
+			skygfx::Topology topology;
+			skygfx::utils::Mesh::Vertices vertices;
+			skygfx::utils::Mesh::Indices indices;
+		};
 
+		struct DrawPacket
+		{
+			State state;
+			bool has_effect = false;
+			skygfx::Shader* shader = nullptr;
+			uint32_t uniform_binding = 0;
+			std::vector<uint8_t> uniform_data;
+			skygfx::Texture* texture = nullptr;
+			skygfx::Topology topology;
+			const skygfx::utils::Mesh* mesh = nullptr; // when null, vertices and indices are used
 			skygfx::utils::Mesh::Vertices vertices;
 			skygfx::utils::Mesh::Indices indices;
+			sky::TextMesh::Glyphs glyphs; // of one page, expanded to vertices and indices on replay
+		};
+
+		struct ClearPacket
+		{
+			State state;
+			std::optional<glm::vec4> color;
+			std::optional<float> depth;
+			std::optional<uint8_t> stencil;
+		};
+
+		using Packet = std::variant<BatchPacket, DrawPacket, ClearPacket>;
+
+		struct Context
+		{
+			bool working = false;
+			bool deferred = false;
+			std::stack<State> states;
+			std::optional<State> applied_state;
+			int batches_count = 0;
+			int flush_count = 0;
+
+			struct
+			{
+				std::shared_ptr<skygfx::Texture> texture;
+				std::optional<skygfx::Topology> topology;
+
+				skygfx::utils::Mesh::Vertices vertices;
+				skygfx::utils::Mesh::Indices indices;
+
+				skygfx::utils::Mesh mesh;
+			} batch;
+
+			skygfx::utils::MeshBuilder mesh_builder;
+			skygfx::utils::Mesh::Vertices emit_vertices;
+			skygfx::utils::Mesh::Indices emit_indices;
+			skygfx::utils::Mesh::Vertices glyph_vertices;
+			skygfx::utils::Mesh::Indices glyph_indices;
+			sky::effects::Effect<sky::effects::Circle> circle_effect;
+			sky::effects::Effect<sky::effects::Sdf> sdf_effect;
+			sky::effects::Effect<sky::effects::Rounded> rounded_effect;
+			std::vector<Packet> packets;
+		};
+
+		Context& getContext();
+		const Context& getContext() const;
+
+	private:
+		Context mContext;
+		static thread_local Context* CurrentContext;
+
+	public:
+		// returned target can be larger than requested (rounded to size class),
+		// it is valid until the end of current frame and should not be kept
+		std::shared_ptr<skygfx::RenderTarget> getRenderTarget(uint32_t width, uint32_t height,
+			skygfx::PixelFormat format = skygfx::PixelFormat::RGBA8UNorm);
+		std::shared_ptr<skygfx::RenderTarget> getRenderTarget();
 
-			skygfx::utils::Mesh mesh;
-		} mBatch;
+		const auto& getRenderTargetPool() const { return mRenderTargetPool; }
+
+	private:
+		RenderTargetPool mRenderTargetPool;
 
 	public:
-		std::shared_ptr<skygfx::RenderTarget> getRenderTarget(const std::string& name, uint32_t width, uint32_t height);
-		std::shared_ptr<skygfx::RenderTarget> getRenderTarget(const std::string& name);
+		// texture content must not change after registration
+		void addPageableTexture(std::shared_ptr<skygfx::Texture> texture);
+
+		bool isTexturePaging() const { return mTexturePaging; }
+		void setTexturePaging(bool value);
 
-		const auto& getRenderTargets() const { return mRenderTargets; }
+		const auto& getTexturePages() const { return mTexturePages; }
 
 	private:
-		std::map<std::string, std::shared_ptr<skygfx::RenderTarget>> mRenderTargets;
-		std::set<std::string> mUnusedRenderTargets;
+		const TexturePages::Placement* getTexturePlacement(skygfx::Texture* texture);
+
+	private:
+		TexturePages mTexturePages;
+		bool mTexturePaging = false;
+		bool mCopyingToPage = false;
 
 	public:
 		std::shared_ptr<skygfx::Texture> makeGenericTexture(const glm::ivec2& size, std::function<void()> callback);
 
 	private:
 		std::shared_ptr<skygfx::Texture> mWhiteCircleTexture = nullptr;
-		sky::effects::Effect<sky::effects::Circle> mCircleEffect;
-		sky::effects::Effect<sky::effects::Sdf> mSdfEffect;
-		sky::effects::Effect<sky::effects::Rounded> mRoundedEffect;
 		skygfx::utils::Mesh mMesh;
-		skygfx::utils::MeshBuilder mMeshBuilder;
 
 	private:
 		sky::CVar<float> mSdfSmoothFactor = sky::CVar<float>("gl_sdf_smooth_factor", 0.5f);
+		sky::CVar<int> mRenderTargetBudget = sky::CVar<int>("r_target_pool_budget_mb", 256, "vram budget for transient render targets");
 	};
+
+	class System::CommandList
+	{
+		friend System;
+
+	public:
+		CommandList() = default; // should be created on main thread
+		CommandList(const CommandList&) = delete;
+		CommandList& operator=(const CommandList&) = delete;
+
+	public:
+		bool isEmpty() const { return mContext.packets.empty(); }
+
+		// pooled targets can be different on next frame, such lists are not retained
+		bool isSingleTarget(const std::shared_ptr<skygfx::RenderTarget>& target) const;
+
+		// packets of mesh draws point to caller's mesh that is only guaranteed alive until submit,
+		// such lists are not retained either
+		bool hasExternalMeshes() const;
+
+	private:
+		Context mContext;
+	};
+
+	template <typename Callback>
+	void System::draw(sky::effects::IEffect* effect, std::shared_ptr<skygfx::Texture> texture,
+		skygfx::utils::MeshBuilder::Mode mode, Callback&& callback)
+	{
+		auto batch_vertices = effect == nullptr ? beginEmitToBatch(texture, mode) : nullptr;
+
+		if (batch_vertices != nullptr)
+		{
+			auto first = batch_vertices->size();
+			callback([batch_vertices](const skygfx::utils::Mesh::Vertex& vertex) {
+				batch_vertices->push_back(vertex);
+			});
+			endEmitToBatch(std::move(texture), mode, first);
+			return;
+		}
+
+		auto& vertices = getContext().emit_vertices;
+		vertices.clear();
+		callback([&vertices](const skygfx::utils::Mesh::Vertex& vertex) {
+			vertices.push_back(vertex);
+		});
+		drawEmitted(effect, std::move(texture), mode);
+	}
 }
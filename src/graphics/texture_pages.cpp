@@ -0,0 +1,108 @@
+#include "texture_pages.h"
+
+using namespace Graphics;
+
+void TexturePages::add(std::shared_ptr<skygfx::Texture> texture)
+{
+	auto& placement = mPlacements[texture.get()];
+
+	if (placement.page.has_value())
+		mPages[placement.page.value()].placements -= 1;
+
+	placement = Placement{ .texture = texture };
+}
+
+TexturePages::Placement* TexturePages::find(skygfx::Texture* texture)
+{
+	auto it = mPlacements.find(texture);
+
+	if (it == mPlacements.end())
+		return nullptr;
+
+	if (it->second.texture.expired()) // address was reused by another texture
+		return nullptr;
+
+	return &it->second;
+}
+
+bool TexturePages::allocate(Placement& placement, uint32_t width, uint32_t height)
+{
+	if (width > MaxTextureSize || height > MaxTextureSize)
+		return false;
+
+	auto padded_width = width + (Padding * 2);
+	auto padded_height = height + (Padding * 2);
+
+	auto place = [&](size_t page_index, glm::uvec3& shelf) {
+		auto& page = mPages[page_index];
+		placement.page = page_index;
+		placement.pos = { shelf.x + Padding, shelf.y + Padding };
+		placement.uv_offset = glm::vec2(placement.pos) / (float)PageSize;
+		placement.uv_scale = glm::vec2{ (float)width, (float)height } / (float)PageSize;
+		shelf.x += padded_width;
+		page.placements += 1;
+	};
+
+	for (size_t i = 0; i < mPages.size(); i++)
+	{
+		auto& page = mPages[i];
+
+		for (auto& shelf : page.shelves)
+		{
+			if (shelf.z < padded_height || shelf.x + padded_width > PageSize)
+				continue;
+
+			place(i, shelf);
+			return true;
+		}
+
+		if (page.height + padded_height > PageSize)
+			continue;
+
+		page.shelves.push_back({ 0, page.height, padded_height });
+		page.height += padded_height;
+		place(i, page.shelves.back());
+		return true;
+	}
+
+	if (mPages.size() >= MaxPages)
+		return false;
+
+	auto& page = mPages.emplace_back();
+	page.shelves.push_back({ 0, 0, padded_height });
+	page.height = padded_height;
+	place(mPages.size() - 1, page.shelves.back());
+	return true;
+}
+
+void TexturePages::collect()
+{
+	std::erase_if(mPlacements, [&](const auto& pair) {
+		const auto& placement = pair.second;
+
+		if (!placement.texture.expired())
+			return false;
+
+		if (placement.page.has_value())
+			mPages[placement.page.value()].placements -= 1;
+
+		return true;
+	});
+
+	// space is reclaimed only when whole page becomes empty
+	for (auto& page : mPages)
+	{
+		if (page.placements > 0 || page.shelves.empty())
+			continue;
+
+		page.shelves.clear();
+		page.height = 0;
+		page.dirty = true;
+	}
+}
+
+void TexturePages::clear()
+{
+	mPlacements.clear();
+	mPages.clear();
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <skygfx/skygfx.h>
+#include <glm/glm.hpp>
+#include <unordered_map>
+#include <optional>
+#include <memory>
+#include <vector>
+
+namespace Graphics
+{
+	// shared pages for small immutable textures, so batches with different textures can be merged,
+	// textures are copied into pages with shelf packing, texcoords are remapped on batching
+
+	class TexturePages
+	{
+	public:
+		static constexpr uint32_t PageSize = 2048;
+		static constexpr uint32_t MaxTextureSize = 512;
+		static constexpr uint32_t Padding = 1; // edge extrusion for linear filtering
+		static constexpr size_t MaxPages = 4;
+
+		struct Placement
+		{
+			std::weak_ptr<skygfx::Texture> texture;
+			std::optional<size_t> page; // nullopt until packed
+			glm::uvec2 pos = { 0, 0 }; // without padding
+			glm::vec2 uv_offset = { 0.0f, 0.0f };
+			glm::vec2 uv_scale = { 1.0f, 1.0f };
+			bool rejected = false;
+		};
+
+		struct Page
+		{
+			std::shared_ptr<skygfx::RenderTarget> target; // created by owner on first copy, packing works without it
+			std::vector<glm::uvec3> shelves; // x cursor, y, height
+			uint32_t height = 0;
+			size_t placements = 0;
+			bool dirty = true; // should be cleared before next copy
+		};
+
+	public:
+		void add(std::shared_ptr<skygfx::Texture> texture);
+		Placement* find(skygfx::Texture* texture);
+
+		// returns false when there is no room
+		bool allocate(Placement& placement, uint32_t width, uint32_t height);
+		void collect();
+		void clear();
+
+	public:
+		auto& getPages() { return mPages; }
+		const auto& getPages() const { return mPages; }
+		auto getPlacementsCount() const { return mPlacements.size(); }
+
+	private:
+		std::unordered_map<skygfx::Texture*, Placement> mPlacements;
+		std::vector<Page> mPages;
+	};
+}
@@ -12,6 +12,9 @@ float TexturePart::getWidth() const
 	if (mRegion.has_value())
 		return mRegion.value().size.x;
 
+	if (mTexture == nullptr) // headless renderer has no textures
+		return 0.0f;
+
 	return (float)mTexture->getWidth();
 }
 
@@ -20,5 +23,8 @@ float TexturePart::getHeight() const
 	if (mRegion.has_value())
 		return mRegion.value().size.y;
 
+	if (mTexture == nullptr)
+		return 0.0f;
+
 	return (float)mTexture->getHeight();
 }
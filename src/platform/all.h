@@ -7,3 +7,4 @@
 #include "system_android.h"
 //#include "system_ios.h"
 #include "system_glfw.h"
+#include "system_headless.h"
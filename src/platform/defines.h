@@ -8,6 +8,11 @@
 	#define PLATFORM_EMSCRIPTEN
 #endif
 
+#if !defined(PLATFORM_WINDOWS) && !defined(PLATFORM_ANDROID) && !defined(PLATFORM_IOS) && \
+	!defined(PLATFORM_MAC) && !defined(PLATFORM_EMSCRIPTEN)
+	#define PLATFORM_HEADLESS
+#endif
+
 #if defined(PLATFORM_ANDROID) || defined(PLATFORM_IOS)
 	#define PLATFORM_MOBILE
 #endif
@@ -22,4 +27,6 @@
 	#define PLATFORM_NAME "Mac"
 #elif defined(PLATFORM_EMSCRIPTEN)
 	#define PLATFORM_NAME "Emscripten"
+#elif defined(PLATFORM_HEADLESS)
+	#define PLATFORM_NAME "Headless"
 #endif
@@ -0,0 +1,91 @@
+#include "system_headless.h"
+
+#if defined(PLATFORM_HEADLESS)
+
+#include <sky/utils.h>
+#include <regex>
+
+using namespace Platform;
+
+static std::vector<std::string> gArguments;
+
+int main(int argc, char* argv[])
+{
+	gArguments = std::vector<std::string>(argv, argv + argc);
+	sky_main();
+	return 0;
+}
+
+std::shared_ptr<System> System::create(const std::string& appname)
+{
+	return std::make_shared<SystemHeadless>(appname);
+}
+
+SystemHeadless::SystemHeadless(const std::string& appname) : mAppName(appname)
+{
+	// 'frames=600' limits the run for benchmarks, 'resolution=1280x720' sets the virtual screen size
+
+	std::regex frames_pattern(R"(frames=(\d+))");
+	std::regex resolution_pattern(R"(resolution=(\d+)x(\d+))");
+	std::smatch matches;
+
+	for (const auto& arg : gArguments)
+	{
+		if (std::regex_match(arg, matches, frames_pattern))
+		{
+			mFramesLimit = std::stoull(matches[1].str());
+		}
+		else if (std::regex_match(arg, matches, resolution_pattern))
+		{
+			mWidth = std::stoi(matches[1].str());
+			mHeight = std::stoi(matches[2].str());
+		}
+	}
+}
+
+void SystemHeadless::process()
+{
+	if (mFramesLimit.has_value() && mFrameCount >= mFramesLimit.value())
+		mFinished = true;
+
+	mFrameCount += 1;
+}
+
+void SystemHeadless::quit()
+{
+	mFinished = true;
+}
+
+bool SystemHeadless::isFinished() const
+{
+	return mFinished;
+}
+
+void SystemHeadless::resize(int width, int height)
+{
+	mWidth = width;
+	mHeight = height;
+	sky::Emit(ResizeEvent({ width, height }));
+}
+
+const std::vector<std::string>& SystemHeadless::getArguments() const
+{
+	return gArguments;
+}
+
+const unsigned char* SystemHeadless::getJoystickButtons(int jid, int* count) const
+{
+	if (count)
+		*count = 0;
+
+	return nullptr;
+}
+
+const float* SystemHeadless::getJoystickAxes(int jid, int* count) const
+{
+	if (count)
+		*count = 0;
+
+	return nullptr;
+}
+#endif
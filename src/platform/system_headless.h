@@ -0,0 +1,94 @@
+#pragma once
+
+#include <platform/system.h>
+
+#if defined(PLATFORM_HEADLESS)
+
+#include <platform/input.h>
+
+namespace Platform
+{
+	// window-less platform for running scenes on machines without gpu,
+	// frames are driven by process() until quit() or frames limit
+
+	class SystemHeadless : public System
+	{
+	public:
+		SystemHeadless(const std::string& appname);
+
+	public:
+		void process() override;
+		void quit() override;
+
+		bool isFinished() const override;
+
+		int getWidth() const override { return mWidth; }
+		int getHeight() const override { return mHeight; }
+
+		float getScale() const override { return mScale; }
+		void setScale(float value) override { mScale = value; }
+
+		float getSafeAreaTopMargin() const override { return 0.0f; }
+		float getSafeAreaBottomMargin() const override { return 0.0f; }
+		float getSafeAreaLeftMargin() const override { return 0.0f; }
+		float getSafeAreaRightMargin() const override { return 0.0f; }
+
+		bool isKeyPressed(Input::Keyboard::Key key) const override { return false; }
+		bool isKeyPressed(Input::Mouse::Button key) const override { return false; }
+
+		void resize(int width, int height) override;
+		void setTitle(const std::string& text) override { /*nothing*/ }
+
+		void setCursorMode(Input::CursorMode mode) override { mCursorMode = mode; }
+		Input::CursorMode getCursorMode() const override { return mCursorMode; }
+
+		void setCursorPos(int x, int y) override { /*nothing*/ }
+
+		std::string getAppName() const override { return mAppName; }
+
+		void showVirtualKeyboard() override { /*nothing*/ };
+		void hideVirtualKeyboard() override { /*nothing*/ };
+		bool isVirtualKeyboardOpened() const override { return false; };
+
+		std::string getVirtualKeyboardText() const override { return ""; };
+		void setVirtualKeyboardText(const std::string& text) override { /*nothing*/ };
+
+		std::string getUUID() const override { return "headless"; }
+
+		void initializeBilling(const ProductsMap& products) override { /*nothing*/ }
+		void purchase(const std::string& product) override { /*nothing*/ }
+
+		void haptic(HapticType hapticType) override { /*nothing*/ }
+
+		void* getNativeWindowHandle() const override { return nullptr; }
+
+		std::string getClipboardText() const override { return mClipboardText; }
+		void setClipboardText(const std::string& text) override { mClipboardText = text; }
+
+		const std::vector<std::string>& getArguments() const override;
+
+		void updateGamepadMapping(const char* str) override { /*nothing*/ }
+		bool isJoystickPresent(int index) const override { return false; }
+		const unsigned char* getJoystickButtons(int jid, int* count) const override;
+		const float* getJoystickAxes(int jid, int* count) const override;
+		bool getGamepadState(int jid, Input::Joystick::GamepadState* state) const override { return false; }
+
+	public:
+		auto getFrameCount() const { return mFrameCount; }
+
+		auto getFramesLimit() const { return mFramesLimit; }
+		void setFramesLimit(std::optional<uint64_t> value) { mFramesLimit = value; }
+
+	private:
+		std::string mAppName;
+		std::string mClipboardText;
+		float mScale = 1.0f;
+		int mWidth = 800;
+		int mHeight = 600;
+		Input::CursorMode mCursorMode = Input::CursorMode::Normal;
+		bool mFinished = false;
+		uint64_t mFrameCount = 0;
+		std::optional<uint64_t> mFramesLimit;
+	};
+}
+#endif
@@ -40,9 +40,10 @@ Action Actions::HideRecursive(std::shared_ptr<Scene::Node> node, float duration,
 	std::list<Action> actions;
 	std::function<void(std::shared_ptr<Scene::Node> node)> recursive_fill_func;
 	recursive_fill_func = [&](std::shared_ptr<Scene::Node> node){
-		for (auto child : node->getNodes())
+		for (const auto& child : node->getNodes())
 		{
-			recursive_fill_func(child);
+			if (child != nullptr)
+				recursive_fill_func(child);
 		}
 
 		auto color_node = std::dynamic_pointer_cast<Scene::Color>(node);
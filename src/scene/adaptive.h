@@ -44,6 +44,11 @@ namespace Scene
 			mAdaptScale = sky::sanitize(mAdaptScale);
 		}
 
+		bool isTransformDirty() const override
+		{
+			return true; // adapt scale is computed after transform
+		}
+
 	public:
 		void updateAbsoluteSize() override
 		{
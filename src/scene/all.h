@@ -18,6 +18,7 @@
 #include <scene/grid.h>
 #include <scene/label.h>
 #include <scene/node.h>
+#include <scene/node_pool.h>
 #include <scene/rectangle.h>
 #include <scene/render_layer.h>
 #include <scene/rich_label.h>
@@ -29,4 +30,5 @@
 #include <scene/trail.h>
 #include <scene/transform.h>
 #include <scene/tappable.h>
-#include <scene/viewport3d.h>
\ No newline at end of file
+#include <scene/viewport3d.h>
+#include <scene/virtual_list.h>
\ No newline at end of file
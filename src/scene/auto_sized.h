@@ -16,6 +16,9 @@ namespace Scene
 
 			for (const auto& node : this->getNodes())
 			{
+				if (node == nullptr)
+					continue;
+
 				mMaxSize.x = glm::max(mMaxSize.x, node->getX() + node->getAbsoluteWidth());
 				mMaxSize.y = glm::max(mMaxSize.y, node->getY() + node->getAbsoluteHeight());
 			}
@@ -1,3 +1,12 @@
 #include "blend.h"
 
-using namespace Scene;
\ No newline at end of file
+using namespace Scene;
+
+void Blend::setBlendMode(skygfx::BlendMode value)
+{
+	if (mBlendMode == value)
+		return;
+
+	mBlendMode = value;
+	onBlendChanged();
+}
\ No newline at end of file
@@ -6,9 +6,15 @@ namespace Scene
 {
 	class Blend
 	{
+	public:
+		virtual ~Blend() = default;
+
 	public:
 		auto getBlendMode() const { return mBlendMode; }
-		void setBlendMode(skygfx::BlendMode value) { mBlendMode = value; }
+		void setBlendMode(skygfx::BlendMode value);
+
+	protected:
+		virtual void onBlendChanged() {}
 
 	private:
 		skygfx::BlendMode mBlendMode = skygfx::BlendStates::NonPremultiplied;
@@ -1,5 +1,4 @@
 #include "bloom_layer.h"
-#include <fmt/format.h>
 
 using namespace Scene;
 
@@ -11,7 +10,7 @@ BloomLayer::BloomLayer()
 std::shared_ptr<skygfx::RenderTarget> BloomLayer::postprocess(std::shared_ptr<skygfx::RenderTarget> render_texture)
 {
 	render_texture = RenderLayer<Node>::postprocess(render_texture);
-	auto result = GRAPHICS->getRenderTarget(fmt::format("bloom_result_{}", (void*)this), render_texture->getWidth(), render_texture->getHeight());
+	auto result = GRAPHICS->getRenderTarget(render_texture->getWidth(), render_texture->getHeight());
 	GRAPHICS->pushCleanState();
 	GRAPHICS->pushRenderTarget(result);
 	GRAPHICS->clear();
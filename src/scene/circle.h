@@ -11,32 +11,34 @@ namespace Scene
 	protected:
 		void update(sky::Duration dTime) override;
 		void draw() override;
+		void onColorChanged() override { markDrawDirty(); }
+		void onBlendChanged() override { markDrawDirty(); }
 
 	public:
 		auto getRadius() const { return mRadius; }
-		void setRadius(float value) { mRadius = value; }
+		void setRadius(float value) { assignDrawn(mRadius, value); }
 
 		auto getThickness() const { return mThickness; }
-		void setThickness(float value) { mThickness = value; }
+		void setThickness(float value) { assignDrawn(mThickness, value); }
 
 		auto getFill() const { return mFill; }
-		void setFill(float value) { mFill = value; }
+		void setFill(float value) { assignDrawn(mFill, value); }
 
 		auto getPie() const { return mPie; }
-		void setPie(float value) { mPie = value; }
+		void setPie(float value) { assignDrawn(mPie, value); }
 
 		auto getPiePivot() const { return mPiePivot; }
-		void setPiePivot(float value) { mPiePivot = value; }
+		void setPiePivot(float value) { assignDrawn(mPiePivot, value); }
 
 		auto getInnerColor() const { return mInnerColor; }
-		void setInnerColor(const glm::vec4& value) { mInnerColor = value; }
-		void setInnerColor(const glm::vec3& value) { mInnerColor = { value, mInnerColor.a }; }
+		void setInnerColor(const glm::vec4& value) { assignDrawn(mInnerColor, value); }
+		void setInnerColor(const glm::vec3& value) { assignDrawn(mInnerColor, glm::vec4(value, mInnerColor.a)); }
 
 		auto getOuterColor() const { return mOuterColor; }
-		void setOuterColor(const glm::vec4& value) { mOuterColor = value; }
-		void setOuterColor(const glm::vec3& value) { mOuterColor = { value, mOuterColor.a }; }
+		void setOuterColor(const glm::vec4& value) { assignDrawn(mOuterColor, value); }
+		void setOuterColor(const glm::vec3& value) { assignDrawn(mOuterColor, glm::vec4(value, mOuterColor.a)); }
 
-		void setDrawTextureWhenAvailable(bool value) { mDrawTextureWhenAvailable = value; }
+		void setDrawTextureWhenAvailable(bool value) { assignDrawn(mDrawTextureWhenAvailable, value); }
 
 	private:
 		float mRadius = -1.0f;
@@ -53,21 +55,23 @@ namespace Scene
 	{
 	protected:
 		void draw() override;
+		void onColorChanged() override { markDrawDirty(); }
+		void onBlendChanged() override { markDrawDirty(); }
 
 	public:
 		auto getSegments() const { return mSegments; }
-		void setSegments(int value) { mSegments = value; }
+		void setSegments(int value) { assignDrawn(mSegments, value); }
 
 		auto getFill() const { return mFill; }
-		void setFill(float value) { mFill = value; }
+		void setFill(float value) { assignDrawn(mFill, value); }
 
 		auto getInnerColor() const { return mInnerColor; }
-		void setInnerColor(const glm::vec4& value) { mInnerColor = value; }
-		void setInnerColor(const glm::vec3& value) { mInnerColor = { value, mInnerColor.a }; }
+		void setInnerColor(const glm::vec4& value) { assignDrawn(mInnerColor, value); }
+		void setInnerColor(const glm::vec3& value) { assignDrawn(mInnerColor, glm::vec4(value, mInnerColor.a)); }
 
 		auto getOuterColor() const { return mOuterColor; }
-		void setOuterColor(const glm::vec4& value) { mOuterColor = value; }
-		void setOuterColor(const glm::vec3& value) { mOuterColor = { value, mOuterColor.a }; }
+		void setOuterColor(const glm::vec4& value) { assignDrawn(mOuterColor, value); }
+		void setOuterColor(const glm::vec3& value) { assignDrawn(mOuterColor, glm::vec4(value, mOuterColor.a)); }
 
 	private:
 		int mSegments = 32;
@@ -1,4 +1,5 @@
 #include "color.h"
+#include <scene/node.h>
 
 using namespace Scene;
 
@@ -16,3 +17,25 @@ Color::Color(const glm::vec4& color) : Color()
 {
 	setColor(color);
 }
+
+void Color::setColor(const glm::vec4& value)
+{
+	if (mColor == value)
+		return;
+
+	mColor = value;
+	onColorChanged();
+}
+
+// part color
+
+PartColor::PartColor(Node* owner, const glm::vec4& color) : Color(color), mOwner(owner)
+{
+	//
+}
+
+void PartColor::onColorChanged()
+{
+	if (mOwner != nullptr)
+		mOwner->markDrawDirty();
+}
@@ -5,6 +5,8 @@
 
 namespace Scene
 {
+	class Node;
+
 	class Color
 	{
 	public:
@@ -15,17 +17,37 @@ namespace Scene
 
 	public:
 		auto getColor() const { return mColor; }
-		void setColor(const glm::vec4& value) { mColor = value; }
-		void setColor(const glm::vec3& value) { mColor = { value, mColor.a }; }
+		void setColor(const glm::vec4& value);
+		void setColor(const glm::vec3& value) { setColor({ value, mColor.a }); }
 		void setColor(sky::Color value) { setColor(sky::GetColor(value)); }
 
 		auto getRGB() const { return glm::vec3{ mColor.r, mColor.g, mColor.b }; }
 		void setRGB(const glm::vec3& value) { setColor(value); }
 
 		float getAlpha() const { return mColor.a; }
-		void setAlpha(float value) { mColor.a = value; }
+		void setAlpha(float value) { setColor({ getRGB(), value }); }
+
+	protected:
+		virtual void onColorChanged() {}
 
 	private:
 		glm::vec4 mColor = sky::GetColor<glm::vec4>(sky::Color::White);
 	};
+
+	// color that is a part of node (outline, corner), its changes mark draw of owner dirty,
+	// owner unlinks itself on destruction because part can outlive it
+	class PartColor : public Color
+	{
+	public:
+		PartColor(Node* owner, const glm::vec4& color = sky::GetColor<glm::vec4>(sky::Color::White));
+
+	public:
+		void setOwner(Node* value) { mOwner = value; }
+
+	protected:
+		void onColorChanged() override;
+
+	private:
+		Node* mOwner;
+	};
 }
\ No newline at end of file
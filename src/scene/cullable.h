@@ -9,6 +9,11 @@ namespace Scene
 		static_assert(std::is_base_of<Node, T>::value, "T must be derived from Node");
 
 	protected:
+		bool isTransformDirty() const override
+		{
+			return true; // cull target can move independently
+		}
+
 		void updateTransform() override
 		{
 			T::updateTransform();
@@ -54,7 +59,7 @@ namespace Scene
 			T::leaveUpdate();
 
 			auto cull_bounds = mCullTarget.lock()->getGlobalBounds();
-			const auto& nodes = this->getNodes();
+			const auto& nodes = this->getNodes(); // traversal has ended, no detached slots here
 
 			for (const auto& node : nodes)
 			{
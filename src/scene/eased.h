@@ -13,6 +13,11 @@ namespace Scene
 		using T::T;
 
 	protected:
+		bool isTransformDirty() const override
+		{
+			return true; // easing goes on without changes of inputs
+		}
+
 		void updateTransform() override
 		{
 			auto prev_transform = this->getTransform();
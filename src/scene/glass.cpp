@@ -1,5 +1,6 @@
 #include "glass.h"
 #include <common/helpers.h> // invlerp
+#include <sky/renderer.h>
 
 using namespace Scene;
 
@@ -12,6 +13,12 @@ void Glass::draw()
 	if (bounds.size.x <= 0 || bounds.size.y <= 0)
 		return;
 
+	if (RENDERER->isHeadless()) // there is no backbuffer to copy
+	{
+		Sprite::draw();
+		return;
+	}
+
 	auto x = (int)glm::round(bounds.pos.x);
 	auto y = (int)glm::round(bounds.pos.y);
 	auto w = (int)glm::round(bounds.size.x);
@@ -6,6 +6,9 @@ namespace Scene
 {
 	class Glass : public Sprite
 	{
+	public:
+		bool isDrawRecordable() const override { return false; }
+
 	protected:
 		void draw() override;
 
@@ -34,8 +34,11 @@ void Grid::update(sky::Duration dTime)
 				pos.x += get_item_size(*item).x;
 			}
 		};
-		for (auto item : getNodes())
+		for (const auto& item : getNodes())
 		{
+			if (item == nullptr)
+				continue;
+
 			auto item_size = get_item_size(*item);
 			bool break_group = is_need_break_group(group.size(), group_size.x + item_size.x, getAbsoluteWidth());
 			if (break_group)
@@ -61,8 +64,11 @@ void Grid::update(sky::Duration dTime)
 				pos.y += get_item_size(*item).y;
 			}
 		};
-		for (auto item : getNodes())
+		for (const auto& item : getNodes())
 		{
+			if (item == nullptr)
+				continue;
+
 			auto item_size = get_item_size(*item);
 			bool break_group = is_need_break_group(group.size(), group_size.y + item_size.y, getAbsoluteHeight());
 			if (break_group)
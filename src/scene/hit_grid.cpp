@@ -0,0 +1,155 @@
+#include "hit_grid.h"
+
+using namespace Scene;
+
+void HitGrid::refresh(const std::shared_ptr<Node>& root)
+{
+	auto structure_changed = mStructure != Node::StructureVersion.load() || mTouchable != Node::TouchableVersion.load();
+
+	if (mValid && !structure_changed)
+		return;
+
+	if (structure_changed)
+	{
+		mEntries.clear();
+		collect(root);
+		mStructure = Node::StructureVersion.load();
+		mTouchable = Node::TouchableVersion.load();
+	}
+
+	mValid = true;
+
+	auto domain = root->isTransformReady() ? root->getGlobalBounds() : Node::Bounds{};
+	auto changed = structure_changed || domain.pos != mDomain.pos || domain.size != mDomain.size;
+	mDomain = domain;
+
+	for (auto& entry : mEntries)
+	{
+		auto ready = entry.ptr->isTransformReady();
+		auto version = entry.ptr->getTransformVersion();
+
+		if (entry.ready == ready && entry.transform_version == version)
+			continue;
+
+		entry.ready = ready;
+		entry.transform_version = version;
+		entry.placed = false;
+		changed = true;
+
+		if (!ready)
+			continue;
+
+		entry.bounds = entry.ptr->getGlobalBounds();
+		entry.placed = glm::all(glm::isfinite(entry.bounds.pos)) && glm::all(glm::isfinite(entry.bounds.size));
+	}
+
+	if (changed)
+		place();
+}
+
+void HitGrid::clear()
+{
+	mEntries.clear();
+
+	for (auto& cell : mCells)
+	{
+		cell.clear();
+	}
+
+	mStructure.reset();
+	mTouchable.reset();
+	mValid = false;
+}
+
+bool HitGrid::contains(const glm::vec2& pos) const
+{
+	if (!mValid || mDomain.size.x <= 0.0f || mDomain.size.y <= 0.0f)
+		return false;
+
+	return
+		pos.x >= mDomain.pos.x &&
+		pos.y >= mDomain.pos.y &&
+		pos.x <= mDomain.pos.x + mDomain.size.x &&
+		pos.y <= mDomain.pos.y + mDomain.size.y;
+}
+
+void HitGrid::query(const glm::vec2& pos, const Callback& callback) const
+{
+	if (!contains(pos))
+		return;
+
+	auto cell = getCell(pos);
+	const auto& indices = mCells[(cell.y * Size) + cell.x];
+
+	// one unit of slack, exact test is done by node itself
+	const auto slack = glm::vec2{ 1.0f, 1.0f };
+
+	for (auto it = indices.rbegin(); it != indices.rend(); ++it)
+	{
+		const auto& entry = mEntries[*it];
+		auto min = entry.bounds.pos - slack;
+		auto max = entry.bounds.pos + entry.bounds.size + slack;
+
+		if (pos.x < min.x || pos.y < min.y || pos.x > max.x || pos.y > max.y)
+			continue;
+
+		if (auto node = entry.node.lock(); node != nullptr)
+			callback(node);
+	}
+}
+
+void HitGrid::collect(const std::shared_ptr<Node>& node)
+{
+	if (node->isTouchable())
+		mEntries.push_back({ .node = node, .ptr = node.get() });
+
+	for (const auto& child : node->getNodes())
+	{
+		if (child != nullptr)
+			collect(child);
+	}
+}
+
+void HitGrid::place()
+{
+	for (auto& cell : mCells)
+	{
+		cell.clear();
+	}
+
+	if (mDomain.size.x <= 0.0f || mDomain.size.y <= 0.0f)
+		return;
+
+	auto domain_max = mDomain.pos + mDomain.size;
+
+	for (uint32_t i = 0; i < mEntries.size(); i++)
+	{
+		const auto& entry = mEntries[i];
+
+		if (!entry.placed)
+			continue;
+
+		auto min = entry.bounds.pos;
+		auto max = entry.bounds.pos + entry.bounds.size;
+
+		if (max.x < mDomain.pos.x || max.y < mDomain.pos.y || min.x > domain_max.x || min.y > domain_max.y)
+			continue;
+
+		auto min_cell = getCell(min);
+		auto max_cell = getCell(max);
+
+		for (int y = min_cell.y; y <= max_cell.y; y++)
+		{
+			for (int x = min_cell.x; x <= max_cell.x; x++)
+			{
+				mCells[(y * Size) + x].push_back(i);
+			}
+		}
+	}
+}
+
+glm::ivec2 HitGrid::getCell(const glm::vec2& pos) const
+{
+	auto cell = glm::ivec2(glm::floor((pos - mDomain.pos) / mDomain.size * static_cast<float>(Size)));
+	return glm::clamp(cell, glm::ivec2(0), glm::ivec2(Size - 1));
+}
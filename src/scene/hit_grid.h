@@ -0,0 +1,59 @@
+#pragma once
+
+#include <scene/node.h>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <vector>
+
+namespace Scene
+{
+	// uniform grid over global bounds of touchable nodes, used to route touches
+	// without walking the whole tree. entries are in draw order, bounds are recomputed
+	// only for nodes whose transform version was changed since last refresh.
+	// node hitTest is expected to stay inside of node bounds
+
+	class HitGrid
+	{
+	public:
+		static constexpr int Size = 16; // cells per axis
+
+		using Callback = std::function<void(const std::shared_ptr<Node>& node)>;
+
+	public:
+		void refresh(const std::shared_ptr<Node>& root);
+		void invalidate() { mValid = false; }
+		void clear();
+
+		bool contains(const glm::vec2& pos) const;
+
+		// calls callback for every node whose bounds contains pos, topmost first
+		void query(const glm::vec2& pos, const Callback& callback) const;
+
+	public:
+		auto getEntriesCount() const { return mEntries.size(); }
+
+	private:
+		void collect(const std::shared_ptr<Node>& node);
+		void place();
+		glm::ivec2 getCell(const glm::vec2& pos) const;
+
+	private:
+		struct Entry
+		{
+			std::weak_ptr<Node> node;
+			Node* ptr = nullptr;
+			uint64_t transform_version = 0;
+			bool ready = false;
+			bool placed = false;
+			Node::Bounds bounds;
+		};
+
+		std::vector<Entry> mEntries;
+		std::vector<std::vector<uint32_t>> mCells = std::vector<std::vector<uint32_t>>(Size * Size);
+		Node::Bounds mDomain;
+		std::optional<uint64_t> mStructure;
+		std::optional<uint64_t> mTouchable;
+		bool mValid = false;
+	};
+}
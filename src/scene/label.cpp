@@ -1,10 +1,17 @@
 #include "label.h"
-#include <regex>
+#include <array>
+#include <optional>
 #include <sky/utils.h>
+#include <sky/text_mesh_cache.h>
 #include <magic_enum/magic_enum.hpp>
 
 using namespace Scene;
 
+Label::~Label()
+{
+	mOutlineColor->setOwner(nullptr);
+}
+
 void Label::draw()
 {
 	Node::draw();
@@ -15,10 +22,10 @@ void Label::draw()
 	if (getAlpha() <= 0.0f && (mOutlineColor->getAlpha() <= 0.0f || mOutlineThickness <= 0.0f))
 		return;
 
-	if (!mTextMesh.has_value())
+	if (mTextMesh == nullptr)
 		return;
 
-	if (mTextMesh.value().getVertices().empty())
+	if (mTextMesh->getGlyphs().empty())
 		return;
 
 	auto scale = mSettings.font->getScaleFactorForSize(mSettings.font_size);
@@ -35,115 +42,275 @@ void Label::draw()
 
 	GRAPHICS->pushSampler(skygfx::Sampler::Linear);
 	GRAPHICS->pushModelMatrix(model);
-	GRAPHICS->drawString(*mSettings.font, mTextMesh.value(), bold, getColor(), mOutlineThickness, mOutlineColor->getColor());
+	GRAPHICS->drawString(*mSettings.font, *mTextMesh, bold, getColor(), mOutlineThickness, mOutlineColor->getColor());
 	GRAPHICS->pop(2);
 }
 
+glm::vec2 Label::getDrawOverflow() const
+{
+	// glyph quads are larger than advances by sdf padding, outline and bold reach into it
+	auto padding = Graphics::Font::SdfPadding * Graphics::Font::getScaleFactorForSize(mSettings.font_size);
+	return { padding, padding };
+}
+
 void Label::update(sky::Duration dTime)
 {
 	Node::update(dTime);
 	refresh();
 }
 
-static std::tuple<std::vector<glm::vec4>, std::wstring> ParseColorTags(std::wstring str)
+// hand written matcher of color tags, grammar is case insensitive:
+// <color=rgba(r,g,b,a)>, <color=rgb(r,g,b)> - integer components
+// <color=frgba(r,g,b,a)>, <color=frgb(r,g,b)> - decimal components
+// <color=hex(rrggbb)>, <color=hex(rrggbbaa)>, <color=name> and </color>
+
+static bool IsMarkupSpace(wchar_t c)
 {
-	auto parse_u8_color = [](auto match) {
-		auto r = static_cast<uint8_t>(std::stoi(match[1]));
-		auto g = static_cast<uint8_t>(std::stoi(match[2]));
-		auto b = static_cast<uint8_t>(std::stoi(match[3]));
-		auto a = match.size() > 4 ? static_cast<uint8_t>(std::stoi(match[4])) : 255;
-		return sky::ColorToNormalized(r, g, b, a);
-	};
+	return c == L' ' || (c >= L'\t' && c <= L'\r');
+}
 
-	auto parse_float_color = [](auto match) {
-		auto r = std::stof(match[1]);
-		auto g = std::stof(match[2]);
-		auto b = std::stof(match[3]);
-		auto a = match.size() > 4 ? std::stof(match[4]) : 1.0f;
-		return glm::vec4{ r, g, b, a };
-	};
+static bool IsMarkupDigit(wchar_t c)
+{
+	return c >= L'0' && c <= L'9';
+}
+
+static bool IsMarkupHexDigit(wchar_t c)
+{
+	return IsMarkupDigit(c) || (c >= L'a' && c <= L'f') || (c >= L'A' && c <= L'F');
+}
+
+static bool IsMarkupLetter(wchar_t c)
+{
+	return (c >= L'a' && c <= L'z') || (c >= L'A' && c <= L'Z');
+}
+
+static bool ReadMarkupLiteral(const wchar_t*& pos, const wchar_t* end, std::wstring_view lowercase_text)
+{
+	if (static_cast<size_t>(end - pos) < lowercase_text.size())
+		return false;
+
+	for (size_t i = 0; i < lowercase_text.size(); i++)
+	{
+		auto c = pos[i];
+
+		if (c >= L'A' && c <= L'Z')
+			c += L'a' - L'A';
+
+		if (c != lowercase_text[i])
+			return false;
+	}
+
+	pos += lowercase_text.size();
+	return true;
+}
+
+static void SkipMarkupSpaces(const wchar_t*& pos, const wchar_t* end)
+{
+	while (pos != end && IsMarkupSpace(*pos))
+		pos++;
+}
+
+static bool ReadMarkupInteger(const wchar_t*& pos, const wchar_t* end)
+{
+	auto begin = pos;
+
+	while (pos != end && IsMarkupDigit(*pos))
+		pos++;
+
+	return pos != begin;
+}
+
+static bool ReadMarkupDecimal(const wchar_t*& pos, const wchar_t* end)
+{
+	if (!ReadMarkupInteger(pos, end))
+		return false;
+
+	if (end - pos >= 2 && pos[0] == L'.' && IsMarkupDigit(pos[1]))
+	{
+		pos++;
+		ReadMarkupInteger(pos, end);
+	}
+
+	return true;
+}
+
+static bool ReadMarkupHex(const wchar_t*& pos, const wchar_t* end)
+{
+	auto begin = pos;
+
+	while (pos != end && IsMarkupHexDigit(*pos))
+		pos++;
+
+	auto length = pos - begin;
+	return length == 6 || length == 8;
+}
+
+// reads "(arg, arg, ...)>", remembers where every argument starts
+template <size_t Count, typename Reader>
+static bool ReadMarkupArguments(const wchar_t*& pos, const wchar_t* end,
+	std::array<const wchar_t*, Count>& args, Reader reader)
+{
+	if (!ReadMarkupLiteral(pos, end, L"("))
+		return false;
+
+	for (size_t i = 0; i < Count; i++)
+	{
+		SkipMarkupSpaces(pos, end);
+		args[i] = pos;
+
+		if (!reader(pos, end))
+			return false;
+
+		SkipMarkupSpaces(pos, end);
+
+		if (!ReadMarkupLiteral(pos, end, i + 1 < Count ? L"," : L")"))
+			return false;
+	}
+
+	return ReadMarkupLiteral(pos, end, L">");
+}
+
+// arguments are validated before conversion, so they end at first foreign symbol
+
+static uint8_t ParseMarkupU8(const wchar_t* arg)
+{
+	return static_cast<uint8_t>(std::wcstol(arg, nullptr, 10));
+}
+
+static float ParseMarkupFloat(const wchar_t* arg)
+{
+	return std::wcstof(arg, nullptr);
+}
+
+static std::optional<glm::vec4> ReadColorPushTag(const wchar_t*& pos, const wchar_t* end)
+{
+	auto body = pos;
+
+	if (!ReadMarkupLiteral(body, end, L"<color="))
+		return std::nullopt;
+
+	std::array<const wchar_t*, 4> args4;
+	std::array<const wchar_t*, 3> args3;
+	std::array<const wchar_t*, 1> args1;
+
+	if (auto p = body; ReadMarkupLiteral(p, end, L"rgba") && ReadMarkupArguments(p, end, args4, ReadMarkupInteger))
+	{
+		pos = p;
+		return sky::ColorToNormalized(ParseMarkupU8(args4[0]), ParseMarkupU8(args4[1]),
+			ParseMarkupU8(args4[2]), ParseMarkupU8(args4[3]));
+	}
+
+	if (auto p = body; ReadMarkupLiteral(p, end, L"rgb") && ReadMarkupArguments(p, end, args3, ReadMarkupInteger))
+	{
+		pos = p;
+		return sky::ColorToNormalized(ParseMarkupU8(args3[0]), ParseMarkupU8(args3[1]),
+			ParseMarkupU8(args3[2]));
+	}
+
+	if (auto p = body; ReadMarkupLiteral(p, end, L"frgba") && ReadMarkupArguments(p, end, args4, ReadMarkupDecimal))
+	{
+		pos = p;
+		return glm::vec4{ ParseMarkupFloat(args4[0]), ParseMarkupFloat(args4[1]),
+			ParseMarkupFloat(args4[2]), ParseMarkupFloat(args4[3]) };
+	}
+
+	if (auto p = body; ReadMarkupLiteral(p, end, L"frgb") && ReadMarkupArguments(p, end, args3, ReadMarkupDecimal))
+	{
+		pos = p;
+		return glm::vec4{ ParseMarkupFloat(args3[0]), ParseMarkupFloat(args3[1]),
+			ParseMarkupFloat(args3[2]), 1.0f };
+	}
 
-	auto parse_hex_color = [](auto match) {
-		auto hex_color = match[1];
-		auto rgba = std::stoul(hex_color, nullptr, 16);
-		auto has_alpha = hex_color.length() == 8;
+	if (auto p = body; ReadMarkupLiteral(p, end, L"hex") && ReadMarkupArguments(p, end, args1, ReadMarkupHex))
+	{
+		pos = p;
+		auto rgba = std::wcstoul(args1[0], nullptr, 16);
+		auto has_alpha = IsMarkupHexDigit(args1[0][6]);
 		auto r = static_cast<uint8_t>((rgba >> (has_alpha ? 24 : 16)) & 0xFF);
 		auto g = static_cast<uint8_t>((rgba >> (has_alpha ? 16 : 8)) & 0xFF);
 		auto b = static_cast<uint8_t>((rgba >> (has_alpha ? 8 : 0)) & 0xFF);
 		auto a = static_cast<uint8_t>(has_alpha ? (rgba & 0xFF) : 255);
 		return sky::ColorToNormalized(r, g, b, a);
-	};
+	}
 
-	auto parse_named_color = [](auto match) {
-		auto str = sky::to_string(match[1].str());
-		auto type = magic_enum::enum_cast<sky::Color>(str, magic_enum::case_insensitive);
+	auto p = body;
+	SkipMarkupSpaces(p, end);
+	auto name_begin = p;
 
-		if (!type.has_value())
-			return sky::GetColor<glm::vec4>(sky::Color::White);
+	while (p != end && IsMarkupLetter(*p))
+		p++;
 
-		return sky::GetColor<glm::vec4>(type.value());
-	};
+	auto name_end = p;
+	SkipMarkupSpaces(p, end);
 
-	auto wregex = [](std::wstring expression) {
-		return std::wregex(expression, std::regex_constants::ECMAScript | std::regex_constants::icase);
-	};
+	if (name_begin == name_end || !ReadMarkupLiteral(p, end, L">"))
+		return std::nullopt;
 
-	std::vector<std::tuple<std::wregex, std::function<glm::vec4(std::wsmatch match)>>> color_tags = {
-		{ wregex(LR"(^<color=rgba\(\s*(\d+)\s*,\s*(\d+)\s*,\s*(\d+)\s*,\s*(\d+)\s*\)>)"), parse_u8_color },
-		{ wregex(LR"(^<color=rgb\(\s*(\d+)\s*,\s*(\d+)\s*,\s*(\d+)\s*\)>)"), parse_u8_color },
-		{ wregex(LR"(^<color=frgba\(\s*(\d+|\d+\.\d+)\s*,\s*(\d+|\d+\.\d+)\s*,\s*(\d+|\d+\.\d+)\s*,\s*(\d+|\d+\.\d+)\s*\)>)"), parse_float_color },
-		{ wregex(LR"(^<color=frgb\(\s*(\d+|\d+\.\d+)\s*,\s*(\d+|\d+\.\d+)\s*,\s*(\d+|\d+\.\d+)\s*\)>)"), parse_float_color },
-		{ wregex(LR"(^<color=hex\(\s*([0-9A-Fa-f]{6}|[0-9A-Fa-f]{8})\s*\)>)"), parse_hex_color },
-		{ wregex(LR"(^<color=\s*([A-Za-z]+)\s*>)"), parse_named_color },
-	};
+	pos = p;
+
+	auto name = sky::to_string(std::wstring(name_begin, name_end));
+	auto type = magic_enum::enum_cast<sky::Color>(name, magic_enum::case_insensitive);
 
-	std::wsmatch match;
+	return sky::GetColor<glm::vec4>(type.value_or(sky::Color::White));
+}
 
-	std::stack<glm::vec4> color_stack;
-	color_stack.push({ 1.0f, 1.0f, 1.0f, 1.0f });
+void Label::ParseColorTags(const std::wstring& str, std::wstring& result_text, std::vector<glm::vec4>& colormap)
+{
+	colormap.clear();
+	result_text.clear();
 
-	auto parse_color_push_tag = [&] {
-		for (const auto& [regex, callback] : color_tags)
+	colormap.reserve(str.size());
+	result_text.reserve(str.size());
+
+	static thread_local std::vector<glm::vec4> color_stack;
+	color_stack.assign(1, { 1.0f, 1.0f, 1.0f, 1.0f });
+
+	auto pos = str.data();
+	auto end = pos + str.size();
+
+	while (pos != end)
+	{
+		if (*pos == L'<')
 		{
-			if (std::regex_search(str, match, regex))
+			if (auto color = ReadColorPushTag(pos, end); color.has_value())
 			{
-				color_stack.push(callback(match));
-				str.erase(0, match.length());
-				return true;
+				color_stack.push_back(color.value());
+				continue;
+			}
+
+			if (ReadMarkupLiteral(pos, end, L"</color>"))
+			{
+				if (color_stack.size() > 1) // unbalanced closing tags keep base color
+					color_stack.pop_back();
+
+				continue;
 			}
 		}
-		return false;
-	};
 
-	auto pop_color_regex = wregex(LR"(^</color>)");
-	std::wstring result_text;
-	std::vector<glm::vec4> colormap;
+		result_text.push_back(*pos);
+		colormap.push_back(color_stack.back());
+		pos++;
+	}
+}
 
-	while (!str.empty())
-	{
-		if (parse_color_push_tag())
-			continue;
+std::wstring Label::ReplaceEscapedNewlines(const std::wstring& str)
+{
+	std::wstring result;
+	result.reserve(str.size());
 
-		if (std::regex_search(str, match, pop_color_regex))
-		{
-			color_stack.pop();
-			str.erase(0, match.length());
-		}
-		else
+	for (size_t i = 0; i < str.size(); i++)
+	{
+		if (str[i] == L'\\' && i + 1 < str.size() && str[i + 1] == L'n')
 		{
-			result_text.push_back(str.front());
-			str.erase(0, 1);
-			colormap.push_back(color_stack.top());
+			result.push_back(L'\n');
+			i++;
+			continue;
 		}
-	}
 
-	return std::make_tuple(colormap, result_text);
-}
+		result.push_back(str[i]);
+	}
 
-static std::wstring ReplaceEscapedNewlines(const std::wstring& str)
-{
-	std::wregex pattern(LR"(\\n)");
-	return std::regex_replace(str, pattern, L"\n");
+	return result;
 }
 
 void Label::refresh()
@@ -162,6 +329,8 @@ void Label::refresh()
 		}
 	};
 
+	auto text_changed = mPrevSettings.has_value() && mPrevSettings->text != mSettings.text;
+
 	if (mSettings.word_wrap_mode)
 		markDirtyIfChanged(mPrevWidth, width);
 
@@ -170,35 +339,68 @@ void Label::refresh()
 	if (!dirty)
 		return;
 
-	auto text = mSettings.text;
+	markDrawDirty();
 
-	if (mSettings.parse_locale_tags)
-		text = sky::UnfoldLocaleTags(text);
+	// scratch strings keep their capacity, so steady refreshes of counters do not allocate
 
-	if (mSettings.replace_escaped_new_lines)
-		text = ReplaceEscapedNewlines(text);
+	mText = mSettings.text;
 
-	std::vector<glm::vec4> colormap;
+	if (mSettings.parse_locale_tags && mText.find(L"<loc=") != std::wstring::npos)
+		mText = sky::UnfoldLocaleTags(mText);
 
-	if (mSettings.parse_color_tags)
-		std::tie(colormap, text) = ParseColorTags(text);
+	if (mSettings.replace_escaped_new_lines && mText.find(L"\\n") != std::wstring::npos)
+		mText = ReplaceEscapedNewlines(mText);
 
-	if (!mSettings.word_wrap_mode)
+	mColormap.clear();
+
+	if (mSettings.parse_color_tags && mText.find(L'<') != std::wstring::npos)
+	{
+		ParseColorTags(mText, mMarkupText, mColormap);
+		std::swap(mText, mMarkupText);
+	}
+
+	auto max_width = mSettings.word_wrap_mode ? std::optional<float>(width) : std::nullopt;
+
+	// labels that change text after first build own their mesh and rebuild it in place,
+	// static ones share meshes through cache
+
+	if (mOwnedTextMesh != nullptr)
+		mOwnedTextMesh->rebuild(*mSettings.font, mText, max_width, mSettings.font_size, mSettings.align);
+	else if (text_changed)
+		mOwnedTextMesh = std::make_shared<sky::TextMesh>(*mSettings.font, mText, max_width, mSettings.font_size, mSettings.align);
+
+	if (mOwnedTextMesh != nullptr)
+	{
+		mTextMesh = mOwnedTextMesh;
+	}
+	else if (sky::Locator<sky::TextMeshCache>::Exists())
 	{
-		mTextMesh = sky::TextMesh(*mSettings.font, text, std::nullopt, mSettings.font_size, mSettings.align);
-		setWidth(mTextMesh.value().getSize().x);
+		mTextMesh = TEXT_MESH_CACHE->get(mSettings.font, mText, max_width, mSettings.font_size, mSettings.align);
 	}
 	else
 	{
-		mTextMesh = sky::TextMesh(*mSettings.font, text, width, mSettings.font_size, mSettings.align);
+		mTextMesh = std::make_shared<const sky::TextMesh>(*mSettings.font, mText, max_width, mSettings.font_size, mSettings.align);
 	}
 
-	for (size_t i = 0; i < colormap.size(); i++)
+	if (!mColormap.empty())
 	{
-		mTextMesh.value().setSymbolColor(i, colormap.at(i));
+		// cached mesh is shared, colored one is a private copy
+		if (mOwnedTextMesh == nullptr)
+		{
+			mOwnedTextMesh = std::make_shared<sky::TextMesh>(*mTextMesh);
+			mTextMesh = mOwnedTextMesh;
+		}
+
+		for (size_t i = 0; i < mColormap.size(); i++)
+		{
+			mOwnedTextMesh->setSymbolColor(i, mColormap.at(i));
+		}
 	}
 
-	setHeight(mTextMesh.value().getSize().y);
+	if (!mSettings.word_wrap_mode)
+		setWidth(mTextMesh->getSize().x);
+
+	setHeight(mTextMesh->getSize().y);
 
 	updateAbsoluteSize();
 }
@@ -206,7 +408,7 @@ void Label::refresh()
 std::tuple<glm::vec2, glm::vec2> Label::getSymbolBounds(int index)
 {
 	auto scale = mSettings.font->getScaleFactorForSize(mSettings.font_size);
-	const auto& symbol = mTextMesh.value().getSymbols().at(index);
+	const auto& symbol = mTextMesh->getSymbols().at(index);
 	auto pos = symbol.pos * scale;
 	auto size = symbol.size * scale;
 	return { pos, size };
@@ -215,5 +417,5 @@ std::tuple<glm::vec2, glm::vec2> Label::getSymbolBounds(int index)
 float Label::getSymbolLineY(int index)
 {
 	auto scale = mSettings.font->getScaleFactorForSize(mSettings.font_size);
-	return mTextMesh.value().getSymbols().at(index).line_y * scale;
+	return mTextMesh->getSymbols().at(index).line_y * scale;
 }
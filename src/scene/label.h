@@ -21,11 +21,16 @@ namespace Scene
 			ExtraBold
 		};
 
+	public:
+		~Label();
+
 	protected:
 		void draw() override;
+		void onColorChanged() override { markDrawDirty(); }
 		void update(sky::Duration dTime) override;
 
 	public:
+		glm::vec2 getDrawOverflow() const override;
 		void refresh();
 
 	public:
@@ -36,13 +41,13 @@ namespace Scene
 		void setFontSize(float value) { mSettings.font_size = value; }
 
 		auto getBold() const { return mBold; }
-		void setBold(Bold value) { mBold = value; }
+		void setBold(Bold value) { assignDrawn(mBold, value); }
 
 		const auto& getText() const { return mSettings.text; }
 		void setText(const std::wstring& value) { mSettings.text = value; }
 
 		auto getOutlineThickness() const { return mOutlineThickness; }
-		void setOutlineThickness(float value) { mOutlineThickness = value; }
+		void setOutlineThickness(float value) { assignDrawn(mOutlineThickness, value); }
 
 		auto getOutlineColor() const { return mOutlineColor; }
 
@@ -67,12 +72,21 @@ namespace Scene
 
 		const auto& getTextMesh() const { return mTextMesh; }
 
+	public:
+		// markup passes of refresh, outputs are cleared and refilled, so their capacity is reused
+		static void ParseColorTags(const std::wstring& str, std::wstring& result_text, std::vector<glm::vec4>& colormap);
+		static std::wstring ReplaceEscapedNewlines(const std::wstring& str);
+
 	private:
 		Bold mBold = Bold::None;
-		std::optional<sky::TextMesh> mTextMesh;
+		std::shared_ptr<const sky::TextMesh> mTextMesh; // shared with other labels through text mesh cache
+		std::shared_ptr<sky::TextMesh> mOwnedTextMesh; // when text is changing or colored, rebuilt in place
+		std::wstring mText; // after tags processing
+		std::wstring mMarkupText;
+		std::vector<glm::vec4> mColormap;
 		float mPrevWidth = 0.0f;
 		float mOutlineThickness = 0.0f;
-		std::shared_ptr<Color> mOutlineColor = std::make_shared<Color>(sky::GetColor(sky::Color::Black));
+		std::shared_ptr<PartColor> mOutlineColor = std::make_shared<PartColor>(this, sky::GetColor<glm::vec4>(sky::Color::Black));
 
 		struct Settings
 		{
@@ -22,44 +22,256 @@ Node::~Node()
 	// we should setup parent to nullptr for every child,
 	// because they can be stored locally somewhere
 
-	for (auto node : mNodes)
+	for (const auto& node : mNodes)
+	{
+		if (node != nullptr)
+			node->mParent = nullptr;
+	}
+
+	for (const auto& node : mFrontAttachedNodes)
 	{
 		node->mParent = nullptr;
 	}
+
+	if (mTransformStore != nullptr && mTransformStore->getNode(mTransformIndex) == this)
+		mTransformStore->forget(mTransformIndex);
+
+	if (mDrawCached)
+		DrawCachedNodesCount -= 1;
+
+	if (mBatchGroupId.has_value())
+	{
+		std::lock_guard lock(BatchGroupsMutex);
+		std::erase(BatchGroupNodes[mBatchGroupId.value()], this);
+		BatchGroupsVersion += 1;
+	}
+}
+
+void Node::setBatchGroup(std::optional<std::string> value)
+{
+	if (mBatchGroup == value)
+		return;
+
+	auto id = value.has_value() ? std::optional<uint32_t>(InternBatchGroup(value.value())) : std::nullopt;
+
+	std::lock_guard lock(BatchGroupsMutex);
+
+	if (mBatchGroupId.has_value())
+		std::erase(BatchGroupNodes[mBatchGroupId.value()], this);
+
+	if (id.has_value())
+		BatchGroupNodes[id.value()].push_back(this);
+
+	mBatchGroup = value;
+	mBatchGroupId = id;
+	BatchGroupsVersion += 1;
+}
+
+uint32_t Node::InternBatchGroup(const std::string& name)
+{
+	std::lock_guard lock(BatchGroupsMutex);
+
+	if (auto it = BatchGroupIds.find(name); it != BatchGroupIds.end())
+		return it->second;
+
+	auto id = static_cast<uint32_t>(BatchGroupNodes.size());
+	BatchGroupIds.insert({ name, id });
+	BatchGroupNodes.emplace_back();
+	return id;
+}
+
+std::vector<Node*> Node::GetBatchGroupNodes(uint32_t id)
+{
+	std::lock_guard lock(BatchGroupsMutex);
+	return BatchGroupNodes.at(id);
+}
+
+size_t Node::GetBatchGroupsCount()
+{
+	std::lock_guard lock(BatchGroupsMutex);
+	return BatchGroupNodes.size();
 }
 
 void Node::attach(std::shared_ptr<Node> node, AttachDirection attach_direction)
 {
 	assert(node->mParent == nullptr);
+	assert(IsolatedRoot == nullptr || isInside(*IsolatedRoot)); // isolated update attaches into foreign subtree
 	if (attach_direction == AttachDirection::Back)
 	{
 		mNodes.push_back(node);
 	}
+	else if (mNodesTraversals > 0)
+	{
+		mFrontAttachedNodes.push_back(node); // inserting at front would shift traversal
+	}
 	else
 	{
-		mNodes.push_front(node);
+		mNodes.insert(mNodes.begin(), node);
 	}
 	node->mParent = this;
+	node->markTransformDirty();
+	invalidateSubtreeBounds();
+	markDrawDirty();
+	StructureVersion += 1;
 }
 
 void Node::detach(std::shared_ptr<Node> node)
 {
 	assert(node->mParent == this);
-	mNodes.remove(node);
+	assert(IsolatedRoot == nullptr || isInside(*IsolatedRoot)); // isolated update detaches from foreign subtree
+
+	auto it = std::find(mNodes.begin(), mNodes.end(), node);
+
+	if (it == mNodes.end())
+	{
+		std::erase(mFrontAttachedNodes, node);
+	}
+	else if (mNodesTraversals > 0)
+	{
+		mDetachedNodes.push_back(std::move(*it));
+		*it = nullptr;
+	}
+	else
+	{
+		mNodes.erase(it);
+	}
+
 	node->mParent = nullptr;
+	node->markTransformDirty();
+
+	// detached subtree should not keep slots of store until next rebuild
+	if (node->mTransformStore != nullptr)
+		node->mTransformStore->release(*node);
+
+	markDrawDirty();
+	StructureVersion += 1;
 }
 
 void Node::clear()
 {
-	while (!mNodes.empty())
+	auto nodes = mNodes;
+
+	for (const auto& node : nodes)
+	{
+		if (node != nullptr)
+			detach(node);
+	}
+
+	while (!mFrontAttachedNodes.empty())
+	{
+		detach(mFrontAttachedNodes.back());
+	}
+}
+
+void Node::endNodesTraversal()
+{
+	assert(mNodesTraversals > 0);
+	mNodesTraversals -= 1;
+
+	if (mNodesTraversals > 0)
+		return;
+
+	if (!mDetachedNodes.empty())
 	{
-		detach(mNodes.front());
+		std::erase(mNodes, nullptr);
+		mDetachedNodes.clear();
+	}
+
+	if (!mFrontAttachedNodes.empty())
+	{
+		mNodes.insert(mNodes.begin(), mFrontAttachedNodes.rbegin(), mFrontAttachedNodes.rend());
+		mFrontAttachedNodes.clear();
 	}
 }
 
 void Node::sort(SortPredicate predicate)
 {
-	mNodes.sort(predicate);
+	assert(mNodesTraversals == 0);
+	std::stable_sort(mNodes.begin(), mNodes.end(), predicate);
+	markDrawDirty();
+	StructureVersion += 1;
+}
+
+void Node::setEnabled(bool value)
+{
+	if (value == mEnabled)
+		return;
+
+	if (value)
+		invalidateSubtreeBounds(); // bounds of disabled subtree were not tracked
+
+	mEnabled = value;
+	markDrawDirty();
+}
+
+void Node::setVisible(bool value)
+{
+	if (value == mVisible)
+		return;
+
+	mVisible = value;
+	markDrawDirty();
+}
+
+void Node::setDrawCached(bool value)
+{
+	if (value == mDrawCached)
+		return;
+
+	mDrawCached = value;
+	mDrawCacheValid = false;
+	DrawCachedNodesCount += value ? 1 : -1;
+
+	if (!value)
+		mDrawCache.reset();
+}
+
+void Node::markDrawDirty()
+{
+	if (DrawCachedNodesCount == 0)
+		return;
+
+	for (auto node = this; node != nullptr; node = node->mParent)
+	{
+		node->mDrawCacheValid = false;
+
+		if (node == IsolatedRoot)
+		{
+			node->mDrawDirtyPending = true;
+			break;
+		}
+	}
+}
+
+void Node::invalidateSubtreeBounds()
+{
+	for (auto node = this; node != nullptr; node = node->mParent)
+	{
+		node->mSubtreeBoundsTick = 0;
+
+		if (node == IsolatedRoot)
+			break; // ancestors of isolated subtree are computed after it on main thread
+	}
+}
+
+bool Node::isInside(const Node& root) const
+{
+	for (auto node = this; node != nullptr; node = node->mParent)
+	{
+		if (node == &root)
+			return true;
+	}
+
+	return false;
+}
+
+void Node::setTouchable(bool value)
+{
+	if (mTouchable == value)
+		return;
+
+	mTouchable = value;
+	TouchableVersion += 1; // touchable nodes are indexed by scene hit grid
 }
 
 glm::vec2 Node::project(const glm::vec2& value) const
@@ -72,15 +284,10 @@ glm::vec2 Node::project(const glm::vec2& value) const
 	if (scene == nullptr)
 		throw std::runtime_error("scene is null");
 
-	auto vp = scene->getViewport();
-	auto scaled_size = vp.size / PLATFORM->getScale();
+	// ortho projection of scaled viewport maps world to screen by platform scale only
+	auto world = TransformStore::FromMatrix(getTransform());
 
-	glm::vec3 original = { value, 0.0f };
-	glm::mat4 projection = glm::orthoLH(0.0f, scaled_size.x, scaled_size.y, 0.0f, -1.0f, 1.0f);
-	glm::vec4 viewport = { 0.0f, vp.size.y, vp.size.x, -vp.size.y };
-	glm::vec3 result = glm::project(original, getTransform(), projection, viewport);
-
-	return { result.x, result.y };
+	return TransformStore::Apply(world, value) * PLATFORM->getScale();
 }
 
 glm::vec2 Node::unproject(const glm::vec2& value) const
@@ -93,23 +300,23 @@ glm::vec2 Node::unproject(const glm::vec2& value) const
 	if (scene == nullptr)
 		throw std::runtime_error("scene is null");
 
-	auto vp = scene->getViewport();
-	auto scaled_size = vp.size / PLATFORM->getScale();
+	auto world = TransformStore::FromMatrix(getTransform());
 
-	glm::vec3 original = { value, 0.0f };
-	glm::mat4 projection = glm::orthoLH(0.0f, scaled_size.x, scaled_size.y, 0.0f, -1.0f, 1.0f);
-	glm::vec4 viewport = { 0.0f, vp.size.y, vp.size.x, -vp.size.y };
-	glm::vec3 result = glm::unProject(original, getTransform(), projection, viewport);
+	if (world.x != mInverseSource.x || world.y != mInverseSource.y || world.t != mInverseSource.t)
+	{
+		mInverseTransform = TransformStore::Inverse(world);
+		mInverseSource = world;
+	}
 
-	return { result.x, result.y };
+	return TransformStore::Apply(mInverseTransform, value / PLATFORM->getScale());
 }
 
-Node::Bounds Node::getGlobalBounds() const
+Node::Bounds Node::getGlobalBounds(const glm::vec2& margin) const
 {
-	auto tl = project({ 0.0f, 0.0f });
-	auto tr = project({ getAbsoluteWidth(), 0.0f });
-	auto bl = project({ 0.0f, getAbsoluteHeight() });
-	auto br = project({ getAbsoluteWidth(), getAbsoluteHeight() });
+	auto tl = project({ -margin.x, -margin.y });
+	auto tr = project({ getAbsoluteWidth() + margin.x, -margin.y });
+	auto bl = project({ -margin.x, getAbsoluteHeight() + margin.y });
+	auto br = project({ getAbsoluteWidth() + margin.x, getAbsoluteHeight() + margin.y });
 
 	auto min = glm::min(glm::min(tl, tr), glm::min(bl, br));
 	auto max = glm::max(glm::max(tl, tr), glm::max(bl, br));
@@ -146,15 +353,38 @@ void Node::updateTransform()
 {
 	auto parent_size = hasParent() ? getParent()->getAbsoluteSize() : (getScene()->getViewport().size / PLATFORM->getScale());
 
-	mTransform = hasParent() ? getParent()->getTransform() : glm::mat4(1.0f);
-	mTransform = glm::translate(mTransform, { getAnchor() * parent_size, 0.0f });
-	mTransform = glm::translate(mTransform, { getPosition(), 0.0f });
-	mTransform = glm::rotate(mTransform, getRotation(), { 0.0f, 0.0f, 1.0f });
-	mTransform = glm::rotate(mTransform, getRadialAnchor() * glm::pi<float>() * 2.0f, { 0.0f, 0.0f, 1.0f });
-	mTransform = glm::rotate(mTransform, -getRadialPivot() * glm::pi<float>() * 2.0f, { 0.0f, 0.0f, 1.0f });
-	mTransform = glm::scale(mTransform, { getScale(), 1.0f });
-	mTransform = glm::translate(mTransform, { -getPivot() * getAbsoluteSize(), 0.0f });
-	mTransform = glm::translate(mTransform, { -getOrigin(), 0.0f });
+	// closed form of translate(anchor + position) * rotate * scale * translate(-pivot - origin)
+
+	auto angle = getRotation() + ((getRadialAnchor() - getRadialPivot()) * glm::pi<float>() * 2.0f);
+	auto cos = glm::cos(angle);
+	auto sin = glm::sin(angle);
+	auto scale = getScale();
+
+	auto axis_x = glm::vec2{ cos, sin } * scale.x;
+	auto axis_y = glm::vec2{ -sin, cos } * scale.y;
+	auto offset = (-getPivot() * getAbsoluteSize()) - getOrigin();
+	auto translation = (getAnchor() * parent_size) + getPosition() + (axis_x * offset.x) + (axis_y * offset.y);
+
+	if (mTransformStore != nullptr && mTransformStore->getNode(mTransformIndex) == this)
+	{
+		// world is composed later by linear sweep of store, or on first getTransform
+		mTransformStore->setLocal(mTransformIndex, { axis_x, axis_y, translation });
+	}
+	else if (hasParent())
+	{
+		const auto& parent = getParent()->getTransform();
+		mTransform[0] = (parent[0] * axis_x.x) + (parent[1] * axis_x.y);
+		mTransform[1] = (parent[0] * axis_y.x) + (parent[1] * axis_y.y);
+		mTransform[2] = parent[2];
+		mTransform[3] = (parent[0] * translation.x) + (parent[1] * translation.y) + parent[3];
+	}
+	else
+	{
+		mTransform = glm::mat4(1.0f);
+		mTransform[0] = { axis_x, 0.0f, 0.0f };
+		mTransform[1] = { axis_y, 0.0f, 0.0f };
+		mTransform[3] = { translation, 0.0f, 1.0f };
+	}
 
 	mTransformReady = true;
 }
@@ -178,12 +408,75 @@ void Node::enterUpdate()
 {
 }
 
+const glm::mat4& Node::getTransform() const
+{
+	if (mTransformStore == nullptr || mTransformStore->getNode(mTransformIndex) != this)
+		return mTransform;
+
+	mTransformStore->resolve(mTransformIndex);
+
+	auto version = mTransformStore->getVersion(mTransformIndex);
+
+	if (version != mExpandedVersion)
+	{
+		mTransform = TransformStore::ToMatrix(mTransformStore->getWorld(mTransformIndex));
+		mExpandedVersion = version;
+	}
+
+	return mTransform;
+}
+
+void Node::setTransform(const glm::mat4& value)
+{
+	mTransform = value;
+	mTransformVersion += 1;
+	markDrawDirty();
+
+	if (mTransformStore != nullptr && mTransformStore->getNode(mTransformIndex) == this)
+	{
+		mTransformStore->setWorld(mTransformIndex, TransformStore::FromMatrix(value));
+		mExpandedVersion = mTransformStore->getVersion(mTransformIndex);
+	}
+}
+
+bool Node::isTransformDirty() const
+{
+	if (isTransformChanged() || !mTransformReady)
+		return true;
+
+	if (hasParent())
+		return getParent()->mTransformVersion != mParentTransformVersion;
+
+	return getScene()->getViewport().size != mViewportSize || PLATFORM->getScale() != mPlatformScale;
+}
+
 void Node::update(sky::Duration dTime)
 {
+	if (mActions.hasActions())
+		markDrawDirty(); // actions can change anything that is drawn
+
 	mActions.update(dTime);
+
+	if (!isTransformDirty())
+		return;
+
 	updateAbsoluteSize();
 	updateAbsoluteScale();
 	updateTransform();
+
+	setTransformChanged(false);
+	mTransformVersion += 1;
+	markDrawDirty();
+
+	if (hasParent())
+	{
+		mParentTransformVersion = getParent()->mTransformVersion;
+	}
+	else
+	{
+		mViewportSize = getScene()->getViewport().size;
+		mPlatformScale = PLATFORM->getScale();
+	}
 }
 
 void Node::leaveUpdate()
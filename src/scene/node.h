@@ -1,8 +1,13 @@
 #pragma once
 
+#include <atomic>
 #include <list>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
 #include <graphics/system.h>
 #include <scene/transform.h>
+#include <scene/transform_store.h>
 #include <glm/glm.hpp>
 #include <glm/ext.hpp>
 #include <sky/action.h>
@@ -14,6 +19,7 @@ namespace Scene
 	class Node : public Transform
 	{
 		friend Scene;
+		friend TransformStore;
 
 	protected:
 		enum class Touch
@@ -53,7 +59,7 @@ namespace Scene
 		glm::vec2 project(const glm::vec2& value) const;
 		glm::vec2 unproject(const glm::vec2& value) const;
 
-		Bounds getGlobalBounds() const;
+		Bounds getGlobalBounds(const glm::vec2& margin = { 0.0f, 0.0f }) const; // margin in local units
 
 		virtual Scene* getScene() const;
 		virtual bool hitTest(const glm::vec2& value) const;
@@ -63,6 +69,11 @@ namespace Scene
 		virtual void updateAbsoluteSize();
 		virtual void updateAbsoluteScale();
 
+		// transform is recomputed only when local inputs, parent or viewport were changed,
+		// nodes with time dependent transforms should override it to return true
+		virtual bool isTransformDirty() const;
+		void markTransformDirty() { setTransformChanged(true); }
+
 	protected:
 		virtual void enterUpdate();
 		virtual void update(sky::Duration dTime);
@@ -77,23 +88,32 @@ namespace Scene
 		auto getParent() const { return mParent; }
 		auto hasParent() const { return mParent != nullptr; }
 		auto hasScene() const { return getScene() != nullptr; }
+
+		// while children are traversed (scene update and draw of this node, see beginNodesTraversal)
+		// detached children leave nullptr slots here, so code that walks siblings from update or draw
+		// of a child must skip nullptr, outside of traversal the list has no such slots
 		const auto& getNodes() const { return mNodes; }
-		auto hasNodes() const { return !mNodes.empty(); }
+		auto hasNodes() const { return !mNodes.empty(); } // counts nullptr slots too
+
+		// children can be attached and detached while they are traversed,
+		// detached slots stay as nullptr until traversal ends
+		void beginNodesTraversal() { mNodesTraversals += 1; }
+		void endNodesTraversal();
 
-		const auto& getTransform() const { return mTransform; }
-		void setTransform(const glm::mat4& value) { mTransform = value; }
+		const glm::mat4& getTransform() const;
+		void setTransform(const glm::mat4& value);
 
 		bool isEnabled() const { return mEnabled; }
-		void setEnabled(bool value) { mEnabled = value; }
+		void setEnabled(bool value);
 
 		bool isVisible() const { return mVisible; }
-		void setVisible(bool value) { mVisible = value; }
+		void setVisible(bool value);
 
 		bool isInteractions() const { return mInteractions; }
 		void setInteractions(bool value) { mInteractions = value; }
 
 		bool isTouchable() const { return mTouchable; }
-		void setTouchable(bool value) { mTouchable = value; }
+		void setTouchable(bool value);
 
 		bool isTouchTransparent() const { return mTouchTransparent; }
 		void setTouchTransparent(bool value) { mTouchTransparent = value; }
@@ -101,9 +121,41 @@ namespace Scene
 		auto isTouching() const { return mTouching; }
 
 		auto isTransformReady() const { return mTransformReady; }
+		auto getTransformVersion() const { return mTransformVersion; }
 
 		const auto& getBatchGroup() const { return mBatchGroup; }
-		void setBatchGroup(std::optional<std::string> value) { mBatchGroup = value; }
+		void setBatchGroup(std::optional<std::string> value);
+		auto getBatchGroupId() const { return mBatchGroupId; }
+
+		// subtree can be recorded on worker thread when scene parallel draw is enabled,
+		// its draw code must not touch anything outside of subtree and graphics state
+		bool isParallelDraw() const { return mParallelDraw; }
+		void setParallelDraw(bool value) { mParallelDraw = value; }
+
+		// subtree is updated on thread pool when scene parallel update is enabled,
+		// its update code must not attach, detach or modify anything outside of subtree
+		bool isUpdateIsolated() const { return mUpdateIsolated; }
+		void setUpdateIsolated(bool value) { mUpdateIsolated = value; }
+
+		// draw of subtree is recorded once and replayed until something inside marks it dirty.
+		// transforms, structure, enabled, visible, color and running actions mark it automatically,
+		// other changes that affect draw should call markDrawDirty
+		bool isDrawCached() const { return mDrawCached; }
+		void setDrawCached(bool value);
+		void markDrawDirty();
+
+		// nodes that draw through own render targets or read backbuffer in draw cannot be recorded,
+		// cached subtrees that contain them are drawn directly
+		virtual bool isDrawRecordable() const { return true; }
+
+		// subtree is skipped by scene draw when its bounds are out of view, culling is enabled by scene,
+		// nodes that draw far outside of own bounds or have side effects in draw should opt out
+		bool isCullable() const { return mCullable; }
+		void setCullable(bool value) { mCullable = value; }
+
+		// how far draw reaches beyond own rectangle in local units (outlines, shadows, glows),
+		// culling keeps this margin in view
+		virtual glm::vec2 getDrawOverflow() const { return { 0.0f, 0.0f }; }
 
 		auto getAbsoluteSize() const { return mAbsoluteSize; }
 		auto getAbsoluteWidth() const { return mAbsoluteSize.x; }
@@ -115,10 +167,27 @@ namespace Scene
 		void setAbsoluteSize(const glm::vec2& value) { mAbsoluteSize = value; }
 		void setAbsoluteScale(const glm::vec2& value) { mAbsoluteScale = value; }
 
+		// for fields that draw depends on, cached draw is outdated only on real change
+		template <typename T> void assignDrawn(T& field, const T& value)
+		{
+			if (field == value)
+				return;
+
+			field = value;
+			markDrawDirty();
+		}
+
+	private:
+		void invalidateSubtreeBounds();
+		bool isInside(const Node& root) const;
+
 	private:
 		Node* mParent = nullptr;
-		std::list<std::shared_ptr<Node>> mNodes;
-		glm::mat4 mTransform = glm::mat4(1.0f);
+		std::vector<std::shared_ptr<Node>> mNodes;
+		std::vector<std::shared_ptr<Node>> mDetachedNodes; // kept alive until traversal ends
+		std::vector<std::shared_ptr<Node>> mFrontAttachedNodes;
+		int mNodesTraversals = 0;
+		mutable glm::mat4 mTransform = glm::mat4(1.0f); // lazily expanded when node is in transform store
 		bool mEnabled = true;
 		bool mVisible = true;
 		bool mInteractions = true;
@@ -127,8 +196,53 @@ namespace Scene
 		bool mTouching = false;
 		bool mTransformReady = false;
 		std::optional<std::string> mBatchGroup;
+		std::optional<uint32_t> mBatchGroupId;
+		bool mParallelDraw = false;
+		bool mUpdateIsolated = false;
+		bool mCullable = true;
+		bool mDrawCached = false;
+		bool mDrawCacheValid = false;
+		bool mDrawDirtyPending = false; // dirty mark stopped at isolated root, main thread continues it
+		std::unique_ptr<Graphics::System::CommandList> mDrawCache;
+		Graphics::System::State mDrawCacheState;
+		Bounds mBounds; // global bounds with draw overflow for mBoundsVersion of transform
+		uint64_t mBoundsVersion = 0;
+		glm::vec2 mBoundsOverflow = { 0.0f, 0.0f };
+		Bounds mSubtreeBounds;
+		uint64_t mSubtreeBoundsTick = 0; // scene update tick of subtree bounds, 0 when invalid
+		size_t mSubtreeNodesCount = 1;
 		glm::vec2 mAbsoluteSize = { 0.0f, 0.0f };
 		glm::vec2 mAbsoluteScale = { 1.0f, 1.0f };
+		uint64_t mTransformVersion = 0;
+		uint64_t mParentTransformVersion = 0;
+		glm::vec2 mViewportSize = { 0.0f, 0.0f }; // for nodes without parent
+		float mPlatformScale = 0.0f;
+		TransformStore* mTransformStore = nullptr;
+		int32_t mTransformIndex = -1;
+		mutable uint32_t mExpandedVersion = 0;
+		mutable TransformStore::Affine mInverseSource; // world transform that inverse was computed from
+		mutable TransformStore::Affine mInverseTransform;
+
+	public:
+		static inline std::atomic<uint64_t> StructureVersion = 0; // changes on every attach, detach and sort
+		static inline std::atomic<uint64_t> TouchableVersion = 0; // changes on every touchable change
+		static inline std::atomic<int> DrawCachedNodesCount = 0; // dirty marks are skipped when nothing is cached
+
+	private:
+		static inline thread_local Node* IsolatedRoot = nullptr; // root of subtree updating on this worker
+
+	public:
+		// batch group names are interned to ids, every node with batch group is registered by id
+		static uint32_t InternBatchGroup(const std::string& name);
+		static std::vector<Node*> GetBatchGroupNodes(uint32_t id);
+		static size_t GetBatchGroupsCount();
+
+		static inline std::atomic<uint64_t> BatchGroupsVersion = 0; // changes on every registration
+
+	private:
+		static inline std::mutex BatchGroupsMutex;
+		static inline std::unordered_map<std::string, uint32_t> BatchGroupIds;
+		static inline std::vector<std::vector<Node*>> BatchGroupNodes;
 
 	public:
 		void runAction(sky::Action action) { mActions.add(std::move(action)); }
@@ -0,0 +1,85 @@
+#include "node_pool.h"
+#include <glm/glm.hpp>
+#include <array>
+
+using namespace Scene;
+
+static constexpr size_t SizeClassesCount = SlabPool::MaxBlockSize / SlabPool::Granularity;
+
+SlabPool* SlabPool::Get(size_t size)
+{
+	if (size > MaxBlockSize)
+		return nullptr;
+
+	// never destroyed, pooled nodes can outlive static destructors
+	static auto pools = [] {
+		auto result = new std::array<SlabPool, SizeClassesCount>();
+		for (size_t i = 0; i < SizeClassesCount; i++)
+		{
+			(*result)[i].mBlockSize = (i + 1) * Granularity;
+		}
+		return result;
+	}();
+
+	auto size_class = (glm::max<size_t>(size, 1) + Granularity - 1) / Granularity;
+	return &(*pools)[size_class - 1];
+}
+
+std::vector<SlabPool::Stats> SlabPool::GetStats()
+{
+	std::vector<Stats> result;
+
+	for (size_t i = 0; i < SizeClassesCount; i++)
+	{
+		auto pool = Get((i + 1) * Granularity);
+		std::lock_guard lock(pool->mMutex);
+
+		if (pool->mSlabs.empty())
+			continue;
+
+		result.push_back({
+			.block_size = pool->mBlockSize,
+			.slabs = pool->mSlabs.size(),
+			.used_blocks = pool->mUsedBlocks,
+			.free_blocks = pool->mFreeBlocks
+		});
+	}
+
+	return result;
+}
+
+void* SlabPool::allocate()
+{
+	std::lock_guard lock(mMutex);
+
+	if (mFreeList == nullptr)
+	{
+		auto blocks = glm::max<size_t>(SlabSize / mBlockSize, 1);
+		auto& slab = mSlabs.emplace_back(std::make_unique<std::byte[]>(blocks * mBlockSize));
+
+		// thread new blocks into free list, first block ends up on top
+		for (size_t i = blocks; i > 0; i--)
+		{
+			auto block = slab.get() + ((i - 1) * mBlockSize);
+			*reinterpret_cast<void**>(block) = mFreeList;
+			mFreeList = block;
+		}
+
+		mFreeBlocks += blocks;
+	}
+
+	auto block = mFreeList;
+	mFreeList = *static_cast<void**>(block);
+	mFreeBlocks -= 1;
+	mUsedBlocks += 1;
+	return block;
+}
+
+void SlabPool::deallocate(void* ptr)
+{
+	std::lock_guard lock(mMutex);
+	*static_cast<void**>(ptr) = mFreeList;
+	mFreeList = ptr;
+	mFreeBlocks += 1;
+	mUsedBlocks -= 1;
+}
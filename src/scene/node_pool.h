@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace Scene
+{
+	// fixed size blocks carved from slabs and recycled through free list,
+	// there is one pool per size class, so allocate_shared of same node type
+	// (object and control block together) keeps reusing the same memory
+
+	class SlabPool
+	{
+	public:
+		static constexpr size_t Granularity = 16;
+		static constexpr size_t MaxBlockSize = 4096;
+		static constexpr size_t SlabSize = 64 * 1024;
+
+		struct Stats
+		{
+			size_t block_size = 0;
+			size_t slabs = 0;
+			size_t used_blocks = 0;
+			size_t free_blocks = 0;
+		};
+
+	public:
+		// nullptr when size is too big for pooling
+		static SlabPool* Get(size_t size);
+		static std::vector<Stats> GetStats();
+
+	public:
+		void* allocate();
+		void deallocate(void* ptr);
+
+	private:
+		size_t mBlockSize = 0;
+		std::mutex mMutex;
+		std::vector<std::unique_ptr<std::byte[]>> mSlabs;
+		void* mFreeList = nullptr;
+		size_t mUsedBlocks = 0;
+		size_t mFreeBlocks = 0;
+	};
+
+	template <class T> class PoolAllocator
+	{
+	public:
+		using value_type = T;
+
+	public:
+		PoolAllocator() = default;
+		template <class U> PoolAllocator(const PoolAllocator<U>&) { }
+
+	public:
+		T* allocate(size_t n)
+		{
+			static_assert(alignof(T) <= SlabPool::Granularity);
+
+			if (n == 1)
+			{
+				if (auto pool = SlabPool::Get(sizeof(T)); pool != nullptr)
+					return static_cast<T*>(pool->allocate());
+			}
+
+			return std::allocator<T>().allocate(n);
+		}
+
+		void deallocate(T* ptr, size_t n)
+		{
+			if (n == 1)
+			{
+				if (auto pool = SlabPool::Get(sizeof(T)); pool != nullptr)
+				{
+					pool->deallocate(ptr);
+					return;
+				}
+			}
+
+			std::allocator<T>().deallocate(ptr, n);
+		}
+
+		template <class U> bool operator==(const PoolAllocator<U>&) const { return true; }
+		template <class U> bool operator!=(const PoolAllocator<U>&) const { return false; }
+	};
+
+	// drop-in replacement of std::make_shared for nodes that are created and killed often
+	template <class T, class... Args> std::shared_ptr<T> MakePooled(Args&&... args)
+	{
+		return std::allocate_shared<T>(PoolAllocator<T>(), std::forward<Args>(args)...);
+	}
+}
@@ -2,6 +2,19 @@
 
 using namespace Scene;
 
+Rectangle::~Rectangle()
+{
+	for (auto& [edge, color] : mEdgeColors)
+	{
+		color->setOwner(nullptr);
+	}
+
+	for (auto& [corner, color] : mCornerColors)
+	{
+		color->setOwner(nullptr);
+	}
+}
+
 void Rectangle::draw()
 {
 	Node::draw();
@@ -45,7 +58,7 @@ void Rectangle::draw()
 
 	if (mRounding > 0.0f)
 	{
-		static auto colors = std::vector<glm::vec4>(4);
+		static thread_local auto colors = std::vector<glm::vec4>(4);
 
 		colors[0] = top_left_color;
 		colors[1] = top_right_color;
@@ -24,37 +24,41 @@ namespace Scene
 			Right
 		};
 
+	public:
+		~Rectangle();
+
 	protected:
 		void draw() override;
+		void onColorChanged() override { markDrawDirty(); }
 
 	public:
 		auto getCornerColor(Corner corner) const { return mCornerColors.at(corner); }
 		auto getEdgeColor(Edge edge) const { return mEdgeColors.at(edge); }
 
 	private:
-		std::map<Edge, std::shared_ptr<Color>> mEdgeColors = {
-			{ Edge::Top, std::make_shared<Color>() },
-			{ Edge::Bottom, std::make_shared<Color>() },
-			{ Edge::Left, std::make_shared<Color>() },
-			{ Edge::Right, std::make_shared<Color>() },
+		std::map<Edge, std::shared_ptr<PartColor>> mEdgeColors = {
+			{ Edge::Top, std::make_shared<PartColor>(this) },
+			{ Edge::Bottom, std::make_shared<PartColor>(this) },
+			{ Edge::Left, std::make_shared<PartColor>(this) },
+			{ Edge::Right, std::make_shared<PartColor>(this) },
 		};
 
-		std::map<Corner, std::shared_ptr<Color>> mCornerColors = {
-			{ Corner::TopLeft, std::make_shared<Color>() },
-			{ Corner::TopRight, std::make_shared<Color>() },
-			{ Corner::BottomLeft, std::make_shared<Color>() },
-			{ Corner::BottomRight, std::make_shared<Color>() },
+		std::map<Corner, std::shared_ptr<PartColor>> mCornerColors = {
+			{ Corner::TopLeft, std::make_shared<PartColor>(this) },
+			{ Corner::TopRight, std::make_shared<PartColor>(this) },
+			{ Corner::BottomLeft, std::make_shared<PartColor>(this) },
+			{ Corner::BottomRight, std::make_shared<PartColor>(this) },
 		};
 
 	public:
 		auto getRounding() const { return mRounding; }
-		void setRounding(float value) { mRounding = value; }
+		void setRounding(float value) { assignDrawn(mRounding, value); }
 
 		auto isAbsoluteRounding() const { return mAbsoluteRounding; }
-		void setAbsoluteRounding(bool value) { mAbsoluteRounding = value; }
+		void setAbsoluteRounding(bool value) { assignDrawn(mAbsoluteRounding, value); }
 
 		auto isSlicedSpriteOptimizationEnabled() const { return mSlicedSpriteOptimizationEnabled; }
-		void setSlicedSpriteOptimizationEnabled(bool value) { mSlicedSpriteOptimizationEnabled = value; }
+		void setSlicedSpriteOptimizationEnabled(bool value) { assignDrawn(mSlicedSpriteOptimizationEnabled, value); }
 
 	private:
 		float mRounding = 0.0f;
@@ -19,11 +19,16 @@ namespace Scene
 			mRenderLayerBlend->setBlendMode(skygfx::BlendStates::AlphaBlend);
 		}
 
+	public:
+		bool isDrawRecordable() const override { return !mRenderLayerEnabled && T::isDrawRecordable(); }
+
 	protected:
 		void enterDraw() override
 		{
 			T::enterDraw();
 
+			mLayerDrawing = false;
+
 			if (!mRenderLayerEnabled)
 				return;
 
@@ -40,22 +45,34 @@ namespace Scene
 				auto width = static_cast<int>(glm::floor(bounds.size.x));
 				auto height = static_cast<int>(glm::floor(bounds.size.y));
 
-				auto target = GRAPHICS->getRenderTarget(fmt::format("renderlayer_{}", (void*)this), width, height);
+				mTargetSize = { glm::max(width, 1), glm::max(height, 1) };
+			}
+			else
+			{
+				mTargetSize = { PLATFORM->getWidth(), PLATFORM->getHeight() };
+			}
+
+			auto target = GRAPHICS->getRenderTarget(mTargetSize.x, mTargetSize.y);
+
+			if (target == nullptr) // headless renderer has no targets, content is drawn directly
+				return;
+
+			mLayerDrawing = true;
+
+			GRAPHICS->pushRenderTarget(target);
+			GRAPHICS->pushViewport(skygfx::Viewport{ .size = glm::vec2(mTargetSize) });
+
+			if (mUseLocalTargetSize)
+			{
+				auto bounds = this->getGlobalBounds();
 
 				auto view = glm::mat4(1.0f);
 				view = glm::translate(view, { -bounds.pos, 0.0f });
 				view = glm::scale(view, { PLATFORM->getScale(), PLATFORM->getScale(), 1.0f });
 
-				GRAPHICS->pushRenderTarget(target);
-				GRAPHICS->pushOrthoMatrix(target);
+				GRAPHICS->pushOrthoMatrix((float)mTargetSize.x, (float)mTargetSize.y);
 				GRAPHICS->pushViewMatrix(view);
 			}
-			else
-			{
-				auto target = GRAPHICS->getRenderTarget(fmt::format("renderlayer_{}", (void*)this));
-
-				GRAPHICS->pushRenderTarget(target);
-			}
 
 			GRAPHICS->pushBlendMode(skygfx::BlendMode(skygfx::Blend::SrcAlpha, skygfx::Blend::InvSrcAlpha,
 				skygfx::Blend::One, skygfx::Blend::InvSrcAlpha));
@@ -64,19 +81,25 @@ namespace Scene
 
 		void leaveDraw() override
 		{
-			if (!mRenderLayerEnabled)
+			if (!mLayerDrawing)
 			{
 				T::leaveDraw();
 				return;
 			}
 
 			auto target = GRAPHICS->getCurrentState().render_target;
+			auto target_size = glm::vec2{ static_cast<float>(target->getWidth()), static_cast<float>(target->getHeight()) };
 
-			GRAPHICS->pop(mUseLocalTargetSize ? 4 : 2);
+			GRAPHICS->pop(mUseLocalTargetSize ? 5 : 3);
 
 			if (mPostprocessEnabled)
 				target = postprocess(target);
 
+			// pooled target is rounded up to size class, only top left part is ours
+			auto region_size = glm::vec2(mTargetSize) / target_size *
+				glm::vec2{ static_cast<float>(target->getWidth()), static_cast<float>(target->getHeight()) };
+			auto region = Graphics::TexRegion({ 0.0f, 0.0f }, region_size);
+
 			auto color = getRenderLayerColor()->getColor() * glm::vec4({ glm::vec3(getRenderLayerColor()->getAlpha()), 1.0f });
 
 			if (mUseLocalTargetSize)
@@ -90,7 +113,7 @@ namespace Scene
 			}
 
 			GRAPHICS->pushBlendMode(mRenderLayerBlend->getBlendMode());
-			GRAPHICS->drawTexturedRectangle(nullptr, target, {}, color, color, color, color);
+			GRAPHICS->drawTexturedRectangle(nullptr, target, region, color, color, color, color);
 			GRAPHICS->pop(2);
 
 			T::leaveDraw();
@@ -109,7 +132,7 @@ namespace Scene
 
 	public:
 		bool isRenderLayerEnabled() const { return mRenderLayerEnabled; }
-		void setRenderLayerEnabled(bool value) { mRenderLayerEnabled = value; }
+		void setRenderLayerEnabled(bool value) { mRenderLayerEnabled = value; this->markDrawDirty(); }
 
 		bool isPostprocessEnabled() const { return mPostprocessEnabled; }
 		void setPostprocessEnabled(bool value) { mPostprocessEnabled = value; }
@@ -129,5 +152,7 @@ namespace Scene
 		std::shared_ptr<Blend> mRenderLayerBlend = std::make_shared<Blend>();
 		PostprocessFunc mPostprocessFunc = nullptr;
 		bool mUseLocalTargetSize = true;
+		glm::ivec2 mTargetSize = { 0, 0 };
+		bool mLayerDrawing = false; // between enterDraw and leaveDraw
 	};
 }
\ No newline at end of file
@@ -1,3 +1,12 @@
 #include "sampler.h"
 
-using namespace Scene;
\ No newline at end of file
+using namespace Scene;
+
+void Sampler::setSampler(skygfx::Sampler value)
+{
+	if (mSampler == value)
+		return;
+
+	mSampler = value;
+	onSamplerChanged();
+}
\ No newline at end of file
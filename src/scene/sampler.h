@@ -9,9 +9,15 @@ namespace Scene
 	public:
 		inline static skygfx::Sampler DefaultSampler = skygfx::Sampler::Nearest;
 
+	public:
+		virtual ~Sampler() = default;
+
 	public:
 		auto getSampler() const { return mSampler; }
-		void setSampler(skygfx::Sampler value) { mSampler = value; }
+		void setSampler(skygfx::Sampler value);
+
+	protected:
+		virtual void onSamplerChanged() {}
 
 	private:
 		skygfx::Sampler mSampler = DefaultSampler;
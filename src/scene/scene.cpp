@@ -1,4 +1,6 @@
 #include "scene.h"
+#include <sky/threadpool.h>
+#include <algorithm>
 
 Scene::Scene::Scene()
 {
@@ -12,6 +14,26 @@ Scene::Scene::Scene()
 
 Scene::Scene::~Scene()
 {
+	mTransformStore.clear();
+}
+
+void Scene::Scene::setFlatTransformsEnabled(bool value)
+{
+	mFlatTransformsEnabled = value;
+
+	if (value)
+		return;
+
+	mTransformStore.clear();
+	mTransformStoreStructure.reset();
+}
+
+void Scene::Scene::setHitGridEnabled(bool value)
+{
+	mHitGridEnabled = value;
+
+	if (!value)
+		mHitGrid.clear();
 }
 
 void Scene::Scene::recursiveNodeUpdate(Node& node, sky::Duration delta)
@@ -22,10 +44,147 @@ void Scene::Scene::recursiveNodeUpdate(Node& node, sky::Duration delta)
 	node.enterUpdate();
 	node.update(delta);
 
-	for (auto _node : node.getNodes())
+	// isolated subtrees are not nested into each other's tasks,
+	// transform store is shared by whole tree so it keeps update serial
+	auto parallel = mParallelUpdateEnabled && !mFlatTransformsEnabled && Node::IsolatedRoot == nullptr &&
+		sky::Locator<sky::ThreadPool>::Exists();
+
+	std::vector<std::future<void>> tasks;
+
+	// indexed loop, children can be attached while traversing
+	const auto& nodes = node.getNodes();
+	node.beginNodesTraversal();
+
+	for (size_t i = 0; i < nodes.size(); i++)
+	{
+		auto _node = nodes[i].get();
+
+		if (_node == nullptr)
+			continue;
+
+		if (parallel && _node->isUpdateIsolated() && _node->isEnabled())
+		{
+			tasks.push_back(THREADPOOL->addTask([this, _node, delta] {
+				Node::IsolatedRoot = _node;
+
+				try
+				{
+					recursiveNodeUpdate(*_node, delta);
+				}
+				catch (...)
+				{
+					Node::IsolatedRoot = nullptr;
+					throw;
+				}
+
+				Node::IsolatedRoot = nullptr;
+			}));
+			continue;
+		}
+
 		recursiveNodeUpdate(*_node, delta);
+	}
 
+	// barrier, leaveUpdate of parent and draw pass see finished subtrees
+	for (auto& task : tasks)
+	{
+		task.wait();
+	}
+
+	for (auto& task : tasks)
+	{
+		task.get();
+	}
+
+	if (!tasks.empty())
+	{
+		for (const auto& _node : nodes)
+		{
+			if (_node == nullptr || !_node->mDrawDirtyPending)
+				continue;
+
+			_node->mDrawDirtyPending = false;
+			node.markDrawDirty();
+		}
+	}
+
+	node.endNodesTraversal();
 	node.leaveUpdate();
+
+	if (mCullingEnabled)
+		updateSubtreeBounds(node);
+}
+
+void Scene::Scene::updateSubtreeBounds(Node& node)
+{
+	node.mSubtreeBoundsTick = 0;
+	node.mSubtreeNodesCount = 1;
+
+	if (!node.isTransformReady())
+		return;
+
+	auto overflow = node.getDrawOverflow();
+
+	if (node.mBoundsVersion != node.getTransformVersion() || node.mBoundsOverflow != overflow)
+	{
+		node.mBounds = node.getGlobalBounds(overflow);
+		node.mBoundsVersion = node.getTransformVersion();
+		node.mBoundsOverflow = overflow;
+	}
+
+	auto min = node.mBounds.pos;
+	auto max = node.mBounds.pos + node.mBounds.size;
+	auto valid = node.isCullable();
+
+	for (const auto& child : node.getNodes())
+	{
+		if (child == nullptr || !child->isEnabled())
+			continue;
+
+		node.mSubtreeNodesCount += child->mSubtreeNodesCount;
+
+		if (child->mSubtreeBoundsTick != mUpdateTick)
+		{
+			valid = false;
+			continue;
+		}
+
+		min = glm::min(min, child->mSubtreeBounds.pos);
+		max = glm::max(max, child->mSubtreeBounds.pos + child->mSubtreeBounds.size);
+	}
+
+	node.mSubtreeBounds = { .pos = min, .size = max - min };
+
+	if (valid)
+		node.mSubtreeBoundsTick = mUpdateTick;
+}
+
+bool Scene::Scene::isCulled(const Node& node) const
+{
+	if (node.mSubtreeBoundsTick != mUpdateTick)
+		return false;
+
+	const auto& state = GRAPHICS->getCurrentState();
+
+	// offscreen layers have their own space, nothing is culled inside of them
+	if (state.render_target != mRenderTarget)
+		return false;
+
+	auto view_min = glm::vec2{ 0.0f, 0.0f };
+	auto view_max = mRenderTarget ?
+		glm::vec2{ static_cast<float>(mRenderTarget->getWidth()), static_cast<float>(mRenderTarget->getHeight()) } :
+		glm::vec2{ static_cast<float>(PLATFORM->getWidth()), static_cast<float>(PLATFORM->getHeight()) };
+
+	if (state.scissor.has_value())
+	{
+		view_min = glm::max(view_min, state.scissor->position);
+		view_max = glm::min(view_max, state.scissor->position + state.scissor->size);
+	}
+
+	auto min = node.mSubtreeBounds.pos;
+	auto max = node.mSubtreeBounds.pos + node.mSubtreeBounds.size;
+
+	return max.x < view_min.x || max.y < view_min.y || min.x > view_max.x || min.y > view_max.y;
 }
 
 void Scene::Scene::recursiveNodeDraw(Node& node)
@@ -39,39 +198,261 @@ void Scene::Scene::recursiveNodeDraw(Node& node)
 	if (!node.isTransformReady())
 		return;
 
+	if (mCullingEnabled && isCulled(node))
+	{
+		mCulledNodesCount += node.mSubtreeNodesCount;
+		return;
+	}
+
+	// nested cached nodes and parallel subtrees are recorded into outer list as usual
+	if (mDrawCacheEnabled && node.isDrawCached() && !GRAPHICS->isRecordingCommandList())
+	{
+		drawCached(node);
+		return;
+	}
+
+	mDrawnNodesCount += 1;
+	drawNode(node);
+}
+
+void Scene::Scene::drawNode(Node& node)
+{
 	node.enterDraw();
 
-	const auto& batch_group = node.getBatchGroup();
+	auto batch_group = node.getBatchGroupId();
 
-	if (mBatchGroupsEnabled && batch_group.has_value())
+	// batch groups are not collected inside parallel subtrees
+	if (mBatchGroupsEnabled && batch_group.has_value() && !GRAPHICS->isRecordingCommandList())
 	{
-		drawBatchGroup(batch_group.value());
+		drawBatchGroup(node, batch_group.value());
 	}
 	else
 	{
 		node.draw();
 	}
 
-	for (auto _node : node.getNodes())
-		recursiveNodeDraw(*_node);
+	node.beginNodesTraversal();
+	recursiveNodesDraw(node.getNodes());
+	node.endNodesTraversal();
 
 	node.leaveDraw();
 }
 
-void Scene::Scene::drawBatchGroup(const std::string& name)
+static bool IsSubtreeDrawRecordable(const Scene::Node& node)
 {
-	if (!mBatchGroups.contains(name))
+	if (!node.isDrawRecordable())
+		return false;
+
+	for (const auto& child : node.getNodes())
+	{
+		if (child != nullptr && child->isEnabled() && !IsSubtreeDrawRecordable(*child))
+			return false;
+	}
+
+	return true;
+}
+
+void Scene::Scene::drawCached(Node& node)
+{
+	auto state = GRAPHICS->getCurrentState();
+
+	if (node.mDrawCacheValid && node.mDrawCache != nullptr && node.mDrawCacheState == state)
+	{
+		mDrawCacheHits += 1;
+		GRAPHICS->replay(*node.mDrawCache);
+		return;
+	}
+
+	mDrawCacheMisses += 1;
+
+	// layers acquire targets and run postprocess at once, recording would keep neither
+	if (!IsSubtreeDrawRecordable(node))
+	{
+		node.mDrawCacheValid = false;
+		mDrawnNodesCount += 1;
+		drawNode(node);
+		return;
+	}
+
+	if (node.mDrawCache == nullptr)
+		node.mDrawCache = std::make_unique<Graphics::System::CommandList>();
+
+	// dirty marks made while recording will invalidate it again
+	node.mDrawCacheValid = true;
+	node.mDrawCacheState = state;
+
+	// drawString does not upload while recording, cached packets must not keep missing page textures
+	Graphics::Font::UploadPending();
+
+	GRAPHICS->beginCommandList(*node.mDrawCache, state);
+	mDrawnNodesCount += 1;
+	drawNode(node);
+	GRAPHICS->endCommandList();
+
+	if (!node.mDrawCache->isSingleTarget(state.render_target) || node.mDrawCache->hasExternalMeshes())
+		node.mDrawCacheValid = false;
+
+	GRAPHICS->replay(*node.mDrawCache);
+}
+
+void Scene::Scene::recursiveNodesDraw(const std::vector<std::shared_ptr<Node>>& nodes)
+{
+	if (!mParallelDrawEnabled || GRAPHICS->isRecordingCommandList() || !sky::Locator<sky::ThreadPool>::Exists())
+	{
+		for (size_t i = 0; i < nodes.size(); i++)
+		{
+			if (auto node = nodes[i].get(); node != nullptr)
+				recursiveNodeDraw(*node);
+		}
+
 		return;
+	}
 
-	for (auto node : mBatchGroups.at(name))
+	// indexed loop, serial draws can attach siblings and reallocate vector,
+	// nodes are not attached or detached while parallel subtrees are recorded
+	size_t i = 0;
+
+	while (i < nodes.size())
 	{
-		if (node.expired())
+		auto run_begin = i;
+
+		while (i < nodes.size() && nodes[i] != nullptr && nodes[i]->isParallelDraw())
+		{
+			i++;
+		}
+
+		auto count = i - run_begin;
+
+		if (count == 0)
+		{
+			if (nodes[i] != nullptr)
+				recursiveNodeDraw(*nodes[i]);
+
+			i++;
 			continue;
+		}
+
+		if (count == 1)
+		{
+			// nothing to run in parallel with
+			recursiveNodeDraw(*nodes[run_begin]);
+			continue;
+		}
+
+		while (mCommandLists.size() < count)
+		{
+			mCommandLists.push_back(std::make_unique<Graphics::System::CommandList>());
+		}
+
+		const auto& state = GRAPHICS->getCurrentState();
+
+		// textures of font pages are created on this thread only
+		Graphics::Font::UploadPending();
 
-		node.lock()->draw();
+		std::vector<std::future<void>> tasks;
+		tasks.reserve(count);
+
+		for (size_t index = 0; index < count; index++)
+		{
+			tasks.push_back(THREADPOOL->addTask([this, list = mCommandLists[index].get(), node = nodes[run_begin + index].get(), state] {
+				GRAPHICS->beginCommandList(*list, state);
+				recursiveNodeDraw(*node);
+				GRAPHICS->endCommandList();
+			}));
+		}
+
+		// submit in sibling order so output matches serial draw
+		for (size_t index = 0; index < count; index++)
+		{
+			tasks[index].get();
+			GRAPHICS->submit(*mCommandLists[index]);
+		}
+	}
+}
+
+void Scene::Scene::rebuildBatchGroups()
+{
+	mBatchGroupsStructure = Node::StructureVersion.load();
+	mBatchGroupsRegistry = Node::BatchGroupsVersion.load();
+
+	mBatchGroupLists.resize(Node::GetBatchGroupsCount());
+
+	for (auto& list : mBatchGroupLists)
+	{
+		list.nodes.clear();
 	}
 
-	mBatchGroups.erase(name);
+	if (mBatchGroupLists.empty())
+		return;
+
+	// one walk in draw order fills lists of all groups
+	collectBatchGroups(*mRoot);
+}
+
+void Scene::Scene::collectBatchGroups(Node& node)
+{
+	auto batch_group = node.getBatchGroupId();
+
+	if (batch_group.has_value() && batch_group.value() < mBatchGroupLists.size())
+		mBatchGroupLists[batch_group.value()].nodes.push_back(&node);
+
+	for (const auto& child : node.getNodes())
+	{
+		if (child != nullptr)
+			collectBatchGroups(*child);
+	}
+}
+
+bool Scene::Scene::isBatchGroupsOutdated() const
+{
+	return mBatchGroupsStructure != Node::StructureVersion.load() || mBatchGroupsRegistry != Node::BatchGroupsVersion.load();
+}
+
+bool Scene::Scene::isBatchDrawable(const Node& node) const
+{
+	for (auto _node = &node; _node != nullptr; _node = _node->getParent())
+	{
+		if (!_node->isEnabled() || !_node->isVisible() || !_node->isTransformReady())
+			return false;
+
+		if (mParallelDrawEnabled && _node->isParallelDraw())
+			return false;
+
+		if (mDrawCacheEnabled && _node->isDrawCached())
+			return false;
+	}
+
+	return true;
+}
+
+void Scene::Scene::drawBatchGroup(Node& node, uint32_t id)
+{
+	if (id >= mBatchGroupLists.size())
+	{
+		node.draw();
+		return;
+	}
+
+	auto& list = mBatchGroupLists[id];
+
+	if (list.drawn)
+		return;
+
+	// lists are rebuilt only in frame, when draw of previous nodes changed structure
+	// they can hold destroyed nodes, so rest of group is drawn one by one until next frame
+	if (isBatchGroupsOutdated())
+	{
+		node.draw();
+		return;
+	}
+
+	list.drawn = true;
+
+	for (auto _node : list.nodes)
+	{
+		if (isBatchDrawable(*_node))
+			_node->draw();
+	}
 }
 
 bool Scene::Scene::interactTest(const glm::vec2& pos)
@@ -98,7 +479,7 @@ std::list<std::weak_ptr<Scene::Node>> Scene::Scene::getTouchedNodes(const glm::v
 	return result;
 }
 
-void Scene::Scene::MakeBatchLists(BatchGroups& batchGroups, std::shared_ptr<Node> node)
+void Scene::Scene::MakeBatchLists(BatchGroups& batchGroups, std::shared_ptr<Node> node, bool skip_parallel)
 {
 	if (!node->isEnabled())
 		return;
@@ -109,13 +490,19 @@ void Scene::Scene::MakeBatchLists(BatchGroups& batchGroups, std::shared_ptr<Node
 	if (!node->isTransformReady())
 		return;
 
+	if (skip_parallel && node->isParallelDraw())
+		return;
+
 	const auto& batch_group = node->getBatchGroup();
 
 	if (batch_group.has_value())
 		batchGroups[batch_group.value()].push_back(node);
 
-	for (auto _node : node->getNodes())
-		MakeBatchLists(batchGroups, _node);
+	for (const auto& _node : node->getNodes())
+	{
+		if (_node != nullptr)
+			MakeBatchLists(batchGroups, _node, skip_parallel);
+	}
 }
 
 std::list<std::shared_ptr<Scene::Node>> Scene::Scene::getTouchableNodes(std::shared_ptr<Node> node, const glm::vec2& pos) const
@@ -138,6 +525,9 @@ std::list<std::shared_ptr<Scene::Node>> Scene::Scene::getTouchableNodes(std::sha
 
 	for (auto it = nodes.rbegin(); it != nodes.rend(); ++it)
 	{
+		if (*it == nullptr)
+			continue;
+
 		for (auto node : getTouchableNodes(*it, pos))
 		{
 			result.push_back(node);
@@ -157,7 +547,66 @@ std::list<std::shared_ptr<Scene::Node>> Scene::Scene::getTouchableNodes(std::sha
 
 std::list<std::shared_ptr<Scene::Node>> Scene::Scene::getTouchableNodes(const glm::vec2& pos) const
 {
-	return getTouchableNodes(mRoot, pos);
+	if (!mHitGridEnabled)
+		return getTouchableNodes(mRoot, pos);
+
+	mHitGrid.refresh(mRoot);
+
+	if (!mHitGrid.contains(pos))
+		return getTouchableNodes(mRoot, pos);
+
+	// same rules as recursive search, but only chains of candidates from grid are tested
+
+	std::unordered_map<const Node*, bool> reachable_nodes;
+	std::vector<const Node*> chain;
+
+	auto is_reachable = [&](const Node* node) {
+		auto reachable = true;
+		chain.clear();
+
+		for (; node != nullptr; node = node->getParent())
+		{
+			if (auto it = reachable_nodes.find(node); it != reachable_nodes.end())
+			{
+				reachable = it->second;
+				break;
+			}
+
+			chain.push_back(node);
+		}
+
+		for (auto it = chain.rbegin(); it != chain.rend(); ++it)
+		{
+			auto _node = *it;
+
+			reachable = reachable &&
+				_node->isEnabled() &&
+				_node->isInteractions() &&
+				_node->isTransformReady() &&
+				_node->interactTest(_node->unproject(pos));
+
+			reachable_nodes.insert({ _node, reachable });
+		}
+
+		return reachable;
+	};
+
+	std::list<std::shared_ptr<Node>> result;
+
+	mHitGrid.query(pos, [&](const std::shared_ptr<Node>& node) {
+		if (!node->isTouchable())
+			return;
+
+		if (!is_reachable(node.get()))
+			return;
+
+		if (!node->hitTest(node->unproject(pos)))
+			return;
+
+		result.push_back(node);
+	});
+
+	return result;
 }
 
 std::list<std::shared_ptr<Scene::Node>> Scene::Scene::getNodes(std::shared_ptr<Node> node, const glm::vec2& pos)
@@ -171,12 +620,15 @@ std::list<std::shared_ptr<Scene::Node>> Scene::Scene::getNodes(std::shared_ptr<N
 	if (!node->interactTest(node->unproject(pos)))
 		return { };
 
-	auto& nodes = node->getNodes();
+	const auto& nodes = node->getNodes();
 
 	std::list<std::shared_ptr<Node>> result;
 
 	for (auto it = nodes.rbegin(); it != nodes.rend(); ++it)
 	{
+		if (*it == nullptr)
+			continue;
+
 		for (auto node : getNodes(*it, pos))
 		{
 			result.push_back(node);
@@ -211,9 +663,29 @@ void Scene::Scene::frame()
 	}
 
 	mTimestepFixer.execute([&](auto delta) {
+		mUpdateTick += 1;
+
+		if (mFlatTransformsEnabled)
+		{
+			if (mTransformStoreStructure != Node::StructureVersion.load())
+			{
+				mTransformStore.rebuild(*mRoot);
+				mTransformStoreStructure = Node::StructureVersion.load();
+			}
+			else
+			{
+				mTransformStore.begin();
+			}
+		}
+
 		recursiveNodeUpdate(*mRoot, delta);
+
+		if (mFlatTransformsEnabled)
+			mTransformStore.sweep();
 	});
 
+	mHitGrid.invalidate();
+
 	if (mScreenAdaption.has_value())
 	{
 		auto scale = mViewport.size / mScreenAdaption.value();
@@ -224,16 +696,31 @@ void Scene::Scene::frame()
 
 	if (mBatchGroupsEnabled)
 	{
-		mBatchGroups.clear();
-		MakeBatchLists(mBatchGroups, mRoot);
+		if (isBatchGroupsOutdated())
+			rebuildBatchGroups();
+
+		for (auto& list : mBatchGroupLists)
+		{
+			list.drawn = false;
+		}
 	}
 
+	mDrawnNodesCount = 0;
+	mCulledNodesCount = 0;
+	mDrawCacheHits = 0;
+	mDrawCacheMisses = 0;
+
 	GRAPHICS->begin();
 	GRAPHICS->pushRenderTarget(mRenderTarget);
 	GRAPHICS->pushOrthoMatrix(mRenderTarget);
 	recursiveNodeDraw(*mRoot);
 	GRAPHICS->pop(2);
 	GRAPHICS->end();
+
+	mDrawnNodesCountPublic = mDrawnNodesCount;
+	mCulledNodesCountPublic = mCulledNodesCount;
+	mDrawCacheHitsPublic = mDrawCacheHits;
+	mDrawCacheMissesPublic = mDrawCacheMisses;
 }
 
 size_t Scene::Scene::getNodesCount(std::shared_ptr<Node> node) const
@@ -243,9 +730,10 @@ size_t Scene::Scene::getNodesCount(std::shared_ptr<Node> node) const
 
 	size_t result = 1;
 
-	for (auto _node : node->getNodes())
+	for (const auto& _node : node->getNodes())
 	{
-		result += getNodesCount(_node);
+		if (_node != nullptr)
+			result += getNodesCount(_node);
 	}
 
 	return result;
@@ -4,8 +4,10 @@
 #include <graphics/system.h>
 #include <sky/dispatcher.h>
 #include <scene/node.h>
+#include <scene/hit_grid.h>
 #include <sky/timestep_fixer.h>
 #include <platform/input.h>
+#include <atomic>
 
 namespace Scene
 {
@@ -40,14 +42,24 @@ namespace Scene
 	private:
 		void recursiveNodeUpdate(Node& node, sky::Duration delta);
 		void recursiveNodeDraw(Node& node);
-		void drawBatchGroup(const std::string& name);
+		void drawNode(Node& node);
+		void drawCached(Node& node);
+		void updateSubtreeBounds(Node& node);
+		bool isCulled(const Node& node) const;
+		void recursiveNodesDraw(const std::vector<std::shared_ptr<Node>>& nodes);
+		void rebuildBatchGroups();
+		void collectBatchGroups(Node& node);
+		bool isBatchGroupsOutdated() const;
+		bool isBatchDrawable(const Node& node) const;
+		void drawBatchGroup(Node& node, uint32_t id);
 
 	public:
 		bool interactTest(const glm::vec2& pos);
 		std::list<std::weak_ptr<Node>> getTouchedNodes(const glm::vec2& pos) const;
 
 	public:
-		static void MakeBatchLists(BatchGroups& batchGroups, std::shared_ptr<Node> node);
+		// full tree walk, scene draw keeps its own incremental lists, used by tools
+		static void MakeBatchLists(BatchGroups& batchGroups, std::shared_ptr<Node> node, bool skip_parallel = false);
 
 	private:
 		std::list<std::shared_ptr<Node>> getTouchableNodes(std::shared_ptr<Node> node, const glm::vec2& pos) const;
@@ -70,6 +82,34 @@ namespace Scene
 		bool isBatchGroupsEnabled() const { return mBatchGroupsEnabled; }
 		void setBatchGroupsEnabled(bool value) { mBatchGroupsEnabled = value; }
 
+		bool isParallelDrawEnabled() const { return mParallelDrawEnabled; }
+		void setParallelDrawEnabled(bool value) { mParallelDrawEnabled = value; }
+
+		bool isParallelUpdateEnabled() const { return mParallelUpdateEnabled; }
+		void setParallelUpdateEnabled(bool value) { mParallelUpdateEnabled = value; }
+
+		bool isFlatTransformsEnabled() const { return mFlatTransformsEnabled; }
+		void setFlatTransformsEnabled(bool value);
+
+		const auto& getTransformStore() const { return mTransformStore; }
+
+		bool isHitGridEnabled() const { return mHitGridEnabled; }
+		void setHitGridEnabled(bool value);
+
+		const auto& getHitGrid() const { return mHitGrid; }
+
+		bool isCullingEnabled() const { return mCullingEnabled; }
+		void setCullingEnabled(bool value) { mCullingEnabled = value; }
+
+		auto getDrawnNodesCount() const { return mDrawnNodesCountPublic; }
+		auto getCulledNodesCount() const { return mCulledNodesCountPublic; }
+
+		bool isDrawCacheEnabled() const { return mDrawCacheEnabled; }
+		void setDrawCacheEnabled(bool value) { mDrawCacheEnabled = value; }
+
+		auto getDrawCacheHits() const { return mDrawCacheHitsPublic; }
+		auto getDrawCacheMisses() const { return mDrawCacheMissesPublic; }
+
 		auto& getTimestepFixer() { return mTimestepFixer; }
 
 		void setScreenAdaption(std::optional<glm::vec2> value) { mScreenAdaption = value; }
@@ -80,8 +120,36 @@ namespace Scene
 		std::shared_ptr<skygfx::RenderTarget> mRenderTarget = nullptr;
 		skygfx::Viewport mViewport;
 		InteractTestCallback mInteractTestCallback = nullptr;
-		BatchGroups mBatchGroups;
 		bool mBatchGroupsEnabled = true;
+
+		struct BatchGroupList
+		{
+			std::vector<Node*> nodes; // in draw order, rebuilt only when structure or registry changes
+			bool drawn = false;
+		};
+
+		std::vector<BatchGroupList> mBatchGroupLists; // indexed by interned batch group id
+		std::optional<uint64_t> mBatchGroupsStructure;
+		std::optional<uint64_t> mBatchGroupsRegistry;
+		bool mParallelDrawEnabled = false;
+		bool mParallelUpdateEnabled = false;
+		std::vector<std::unique_ptr<Graphics::System::CommandList>> mCommandLists;
+		bool mFlatTransformsEnabled = false;
+		TransformStore mTransformStore;
+		std::optional<uint64_t> mTransformStoreStructure;
+		bool mHitGridEnabled = true;
+		mutable HitGrid mHitGrid; // refreshed lazily by first touch query of frame
+		bool mCullingEnabled = false;
+		uint64_t mUpdateTick = 0;
+		std::atomic<size_t> mDrawnNodesCount = 0; // parallel draw can count from workers
+		std::atomic<size_t> mCulledNodesCount = 0;
+		size_t mDrawnNodesCountPublic = 0;
+		size_t mCulledNodesCountPublic = 0;
+		bool mDrawCacheEnabled = true;
+		int mDrawCacheHits = 0;
+		int mDrawCacheMisses = 0;
+		int mDrawCacheHitsPublic = 0;
+		int mDrawCacheMissesPublic = 0;
 		sky::TimestepFixer mTimestepFixer;
 		std::optional<glm::vec2> mScreenAdaption;
 	};
@@ -13,13 +13,16 @@ namespace Scene
 	protected:
 		void update(sky::Duration dTime) override;
 		void draw() override;
+		void onColorChanged() override { markDrawDirty(); }
+		void onBlendChanged() override { markDrawDirty(); }
+		void onSamplerChanged() override { markDrawDirty(); }
 
 	public:
 		auto getTexture() const { return mTexture; }
-		void setTexture(std::shared_ptr<skygfx::Texture> value) { mTexture = value; }
+		void setTexture(std::shared_ptr<skygfx::Texture> value) { mTexture = value; markDrawDirty(); }
 
 		const auto& getCenterRegion() const { return mCenterRegion; }
-		void setCenterRegion(const std::optional<Graphics::TexRegion>& value) { mCenterRegion = value; }
+		void setCenterRegion(const std::optional<Graphics::TexRegion>& value) { mCenterRegion = value; markDrawDirty(); }
 
 	private:
 		std::shared_ptr<skygfx::Texture> mTexture = nullptr;
@@ -17,6 +17,9 @@ namespace Scene
 	protected:
 		void update(sky::Duration dTime) override;
 		void draw() override;
+		void onColorChanged() override { markDrawDirty(); }
+		void onBlendChanged() override { markDrawDirty(); }
+		void onSamplerChanged() override { markDrawDirty(); }
 
 	private:
 		void applyTextureWidth();
@@ -27,17 +30,17 @@ namespace Scene
 
 	public:
 		auto getTexture() const { return mTexture; }
-		void setTexture(std::shared_ptr<skygfx::Texture> value) { mTexture = value; }
+		void setTexture(std::shared_ptr<skygfx::Texture> value) { mTexture = value; markDrawDirty(); }
 		void setTexture(const Graphics::TexturePart& value);
 
 		const auto& getTexRegion() const { return mTexRegion; }
-		void setTexRegion(const std::optional<Graphics::TexRegion>& value) { mTexRegion = value; }
+		void setTexRegion(const std::optional<Graphics::TexRegion>& value) { mTexRegion = value; markDrawDirty(); }
 
 		auto getTextureAddress() const { return mTextureAddress; }
-		void setTextureAddress(skygfx::TextureAddress value) { mTextureAddress = value; }
+		void setTextureAddress(skygfx::TextureAddress value) { assignDrawn(mTextureAddress, value); }
 
 		auto getEffect() const { return mEffect; }
-		void setEffect(sky::effects::IEffect* value) { mEffect = value; }
+		void setEffect(sky::effects::IEffect* value) { assignDrawn(mEffect, value); }
 
 	private:
 		std::shared_ptr<skygfx::Texture> mTexture;
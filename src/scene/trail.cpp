@@ -4,6 +4,7 @@ using namespace Scene;
 
 Trail::Trail(std::weak_ptr<Node> holder) : mHolder(holder)
 {
+	setCullable(false); // segments are drawn far from own bounds
 }
 
 void Trail::update(sky::Duration dTime)
@@ -12,6 +13,11 @@ void Trail::update(sky::Duration dTime)
 	mUptime += dTime;
 }
 
+bool Trail::isTransformDirty() const
+{
+	return true; // segments follow the holder and expire over time
+}
+
 void Trail::updateTransform()
 {
 	Node::updateTransform();
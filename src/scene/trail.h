@@ -14,9 +14,11 @@ namespace Scene
 	public:
 		void update(sky::Duration dTime) override;
 		void updateTransform() override;
+		bool isTransformDirty() const override;
 
 	protected:
 		void draw() override;
+		void onColorChanged() override { markDrawDirty(); }
 
 	public:
 		void clearTrail();
@@ -10,37 +10,37 @@ namespace Scene
 		virtual ~Transform() = default;
 
 		auto getSize() const { return mSize; }
-		void setSize(const glm::vec2& value) { mSize = value; }
+		void setSize(const glm::vec2& value) { assign(mSize, value); }
 
 		auto getStretch() const { return mStretch; }
-		void setStretch(const glm::vec2& value) { mStretch = value; }
+		void setStretch(const glm::vec2& value) { assign(mStretch, value); }
 
 		auto getPosition() const { return mPosition; }
-		void setPosition(const glm::vec2& value) { mPosition = value; }
+		void setPosition(const glm::vec2& value) { assign(mPosition, value); }
 
 		auto getOrigin() const { return mOrigin; }
-		void setOrigin(const glm::vec2& value) { mOrigin = value; }
+		void setOrigin(const glm::vec2& value) { assign(mOrigin, value); }
 
 		auto getMargin() const { return mMargin; }
-		void setMargin(const glm::vec2& value) { mMargin = value; }
+		void setMargin(const glm::vec2& value) { assign(mMargin, value); }
 
 		auto getAnchor() const { return mAnchor; }
-		void setAnchor(const glm::vec2& value) { mAnchor = value; }
+		void setAnchor(const glm::vec2& value) { assign(mAnchor, value); }
 
 		auto getPivot() const { return mPivot; }
-		void setPivot(const glm::vec2& value) { mPivot = value; }
+		void setPivot(const glm::vec2& value) { assign(mPivot, value); }
 
 		auto getScale() const { return mScale; }
-		void setScale(const glm::vec2& value) { mScale = value; }
+		void setScale(const glm::vec2& value) { assign(mScale, value); }
 
 		auto getRotation() const { return mRotation; }
-		void setRotation(float value) { mRotation = value; }
+		void setRotation(float value) { assign(mRotation, value); }
 
 		auto getRadialAnchor() const { return mRadialAnchor; }
-		void setRadialAnchor(float value) { mRadialAnchor = value; }
+		void setRadialAnchor(float value) { assign(mRadialAnchor, value); }
 
 		auto getRadialPivot() const { return mRadialPivot; }
-		void setRadialPivot(float value) { mRadialPivot = value; }
+		void setRadialPivot(float value) { assign(mRadialPivot, value); }
 
 	private:
 		glm::vec2 mSize = { 0.0f, 0.0f };
@@ -54,79 +54,94 @@ namespace Scene
 		float mRotation = 0.0f; // radians
 		float mRadialAnchor = 0.0f;
 		float mRadialPivot = 0.0f;
+		bool mTransformChanged = true;
+
+	protected:
+		bool isTransformChanged() const { return mTransformChanged; }
+		void setTransformChanged(bool value) { mTransformChanged = value; }
+
+	private:
+		template <typename T> void assign(T& field, const T& value)
+		{
+			if (field == value)
+				return;
+
+			field = value;
+			mTransformChanged = true;
+		}
 
 	public:
 		auto getWidth() const { return mSize.x; }
-		void setWidth(float value) { mSize.x = value; }
+		void setWidth(float value) { assign(mSize.x, value); }
 
 		auto getHeight() const { return mSize.y; }
-		void setHeight(float value) { mSize.y = value; }
+		void setHeight(float value) { assign(mSize.y, value); }
 
 		auto getHorizontalSize() const { return mSize.x; }
-		void setHorizontalSize(float value) { mSize.x = value; }
+		void setHorizontalSize(float value) { assign(mSize.x, value); }
 
 		auto getVerticalSize() const { return mSize.y; }
-		void setVerticalSize(float value) { mSize.y = value; }
+		void setVerticalSize(float value) { assign(mSize.y, value); }
 
 		void setSize(float value) { setSize({ value, value }); }
 
 		auto getHorizontalStretch() const { return mStretch.x; }
-		void setHorizontalStretch(float value) { mStretch.x = value; }
+		void setHorizontalStretch(float value) { assign(mStretch.x, value); }
 
 		auto getVerticalStretch() const { return mStretch.y; }
-		void setVerticalStretch(float value) { mStretch.y = value; }
+		void setVerticalStretch(float value) { assign(mStretch.y, value); }
 
 		void setStretch(float value) { setStretch({ value, value }); }
 
 		auto getX() const { return mPosition.x; }
-		void setX(float value) { mPosition.x = value; }
+		void setX(float value) { assign(mPosition.x, value); }
 
 		auto getY() const { return mPosition.y; }
-		void setY(float value) { mPosition.y = value; }
+		void setY(float value) { assign(mPosition.y, value); }
 
 		auto getHorizontalPosition() const { return mPosition.x; }
-		void setHorizontalPosition(float value) { mPosition.x = value; }
+		void setHorizontalPosition(float value) { assign(mPosition.x, value); }
 
 		auto getVerticalPosition() const { return mPosition.y; }
-		void setVerticalPosition(float value) { mPosition.y = value; }
+		void setVerticalPosition(float value) { assign(mPosition.y, value); }
 
 		void setOrigin(float value) { setOrigin({ value, value }); }
 
 		auto getHorizontalOrigin() const { return mOrigin.x; }
-		void setHorizontalOrigin(float value) { mOrigin.x = value; }
+		void setHorizontalOrigin(float value) { assign(mOrigin.x, value); }
 
 		auto getVerticalOrigin() const { return mOrigin.y; }
-		void setVerticalOrigin(float value) { mOrigin.y = value; }
+		void setVerticalOrigin(float value) { assign(mOrigin.y, value); }
 
 		auto getHorizontalMargin() const { return mMargin.x; }
-		void setHorizontalMargin(float value) { mMargin.x = value; }
+		void setHorizontalMargin(float value) { assign(mMargin.x, value); }
 
 		auto getVerticalMargin() const { return mMargin.y; }
-		void setVerticalMargin(float value) { mMargin.y = value; }
+		void setVerticalMargin(float value) { assign(mMargin.y, value); }
 
 		void setMargin(float value) { setMargin({ value, value }); }
 
 		auto getHorizontalAnchor() const { return mAnchor.x; }
-		void setHorizontalAnchor(float value) { mAnchor.x = value; }
+		void setHorizontalAnchor(float value) { assign(mAnchor.x, value); }
 
 		auto getVerticalAnchor() const { return mAnchor.y; }
-		void setVerticalAnchor(float value) { mAnchor.y = value; }
+		void setVerticalAnchor(float value) { assign(mAnchor.y, value); }
 
 		void setAnchor(float value) { setAnchor({ value, value }); }
 
 		auto getHorizontalPivot() const { return mPivot.x; }
-		void setHorizontalPivot(float value) { mPivot.x = value; }
+		void setHorizontalPivot(float value) { assign(mPivot.x, value); }
 
 		auto getVerticalPivot() const { return mPivot.y; }
-		void setVerticalPivot(float value) { mPivot.y = value; }
+		void setVerticalPivot(float value) { assign(mPivot.y, value); }
 
 		void setPivot(float value) { setPivot({ value, value }); }
 
 		auto getHorizontalScale() const { return mScale.x; }
-		void setHorizontalScale(float value) { mScale.x = value; }
+		void setHorizontalScale(float value) { assign(mScale.x, value); }
 
 		auto getVerticalScale() const { return mScale.y; }
-		void setVerticalScale(float value) { mScale.y = value; }
+		void setVerticalScale(float value) { assign(mScale.y, value); }
 
 		void setScale(float value) { setScale({ value, value }); }
 	};
@@ -0,0 +1,296 @@
+#include "transform_store.h"
+#include <scene/node.h>
+#include <algorithm>
+
+using namespace Scene;
+
+TransformStore::Affine TransformStore::Compose(const Affine& parent, const Affine& local)
+{
+	return {
+		.x = (parent.x * local.x.x) + (parent.y * local.x.y),
+		.y = (parent.x * local.y.x) + (parent.y * local.y.y),
+		.t = (parent.x * local.t.x) + (parent.y * local.t.y) + parent.t
+	};
+}
+
+TransformStore::Affine TransformStore::Inverse(const Affine& affine)
+{
+	auto det = (affine.x.x * affine.y.y) - (affine.y.x * affine.x.y);
+	auto inv_x = glm::vec2{ affine.y.y, -affine.x.y } / det;
+	auto inv_y = glm::vec2{ -affine.y.x, affine.x.x } / det;
+
+	return {
+		.x = inv_x,
+		.y = inv_y,
+		.t = -((inv_x * affine.t.x) + (inv_y * affine.t.y))
+	};
+}
+
+glm::vec2 TransformStore::Apply(const Affine& affine, const glm::vec2& value)
+{
+	return (affine.x * value.x) + (affine.y * value.y) + affine.t;
+}
+
+glm::mat4 TransformStore::ToMatrix(const Affine& affine)
+{
+	auto result = glm::mat4(1.0f);
+	result[0] = { affine.x, 0.0f, 0.0f };
+	result[1] = { affine.y, 0.0f, 0.0f };
+	result[3] = { affine.t, 0.0f, 1.0f };
+	return result;
+}
+
+TransformStore::Affine TransformStore::FromMatrix(const glm::mat4& matrix)
+{
+	return {
+		.x = { matrix[0].x, matrix[0].y },
+		.y = { matrix[1].x, matrix[1].y },
+		.t = { matrix[3].x, matrix[3].y }
+	};
+}
+
+TransformStore::~TransformStore()
+{
+	clear();
+}
+
+template <typename T>
+static void Gather(std::vector<T>& column, const std::vector<int32_t>& previous, const T& value)
+{
+	auto result = std::vector<T>(previous.size(), value);
+
+	for (size_t i = 0; i < previous.size(); i++)
+	{
+		if (previous[i] >= 0)
+			result[i] = column[previous[i]];
+	}
+
+	column = std::move(result);
+}
+
+void TransformStore::rebuild(Node& root)
+{
+	// nodes that stay in tree carry locals and worlds over to their new slots,
+	// only new nodes wait for next update to fill locals
+	auto prev_nodes = std::move(mNodes);
+	auto prev_parents = std::move(mParents);
+
+	std::vector<int32_t> previous; // previous slot of every new slot, -1 for new nodes
+	mNodes.clear();
+	mParents.clear();
+	mEnds.clear();
+	collect(root, -1, prev_nodes, previous);
+
+	std::vector<bool> kept(prev_nodes.size(), false);
+
+	for (auto index : previous)
+	{
+		if (index >= 0)
+			kept[index] = true;
+	}
+
+	// parents of old slots are still in place, so left nodes can resolve their last world
+	std::swap(mNodes, prev_nodes);
+	std::swap(mParents, prev_parents);
+
+	for (size_t i = 0; i < mNodes.size(); i++)
+	{
+		if (mNodes[i] != nullptr && !kept[i])
+			unlink(static_cast<int32_t>(i));
+	}
+
+	std::swap(mNodes, prev_nodes);
+	std::swap(mParents, prev_parents);
+
+	Gather(mLocalX, previous, { 1.0f, 0.0f });
+	Gather(mLocalY, previous, { 0.0f, 1.0f });
+	Gather(mLocalT, previous, { 0.0f, 0.0f });
+	Gather(mWorldX, previous, { 1.0f, 0.0f });
+	Gather(mWorldY, previous, { 0.0f, 1.0f });
+	Gather(mWorldT, previous, { 0.0f, 0.0f });
+	Gather(mFlags, previous, uint8_t(0));
+	Gather(mVersions, previous, uint32_t(0));
+
+	for (size_t i = 0; i < mNodes.size(); i++)
+	{
+		auto node = mNodes[i];
+		auto index = static_cast<int32_t>(i);
+
+		node->mTransformStore = this;
+		node->mTransformIndex = index;
+
+		if (previous[i] < 0)
+		{
+			auto world = FromMatrix(node->mTransform);
+			mWorldX[i] = world.x;
+			mWorldY[i] = world.y;
+			mWorldT[i] = world.t;
+			node->mExpandedVersion = 0;
+			node->markTransformDirty(); // locals will be filled by next update
+			continue;
+		}
+
+		// moved node composes carried local with its new parent
+		auto prev_parent = prev_parents[previous[i]];
+		auto prev_parent_node = prev_parent >= 0 ? prev_nodes[prev_parent] : nullptr;
+		auto parent_node = mParents[i] >= 0 ? mNodes[mParents[i]] : nullptr;
+
+		mFlags[i] &= Dirty;
+
+		if (prev_parent_node != parent_node)
+			mFlags[i] |= Dirty;
+	}
+}
+
+void TransformStore::collect(Node& node, int32_t parent, const std::vector<Node*>& prev_nodes,
+	std::vector<int32_t>& previous)
+{
+	auto index = static_cast<int32_t>(mNodes.size());
+	auto owned = node.mTransformStore == this && prev_nodes[node.mTransformIndex] == &node;
+
+	mNodes.push_back(&node);
+	mParents.push_back(parent);
+	mEnds.push_back(index + 1);
+	previous.push_back(owned ? node.mTransformIndex : -1);
+
+	for (const auto& child : node.getNodes())
+	{
+		if (child != nullptr)
+			collect(*child, index, prev_nodes, previous);
+	}
+
+	mEnds[index] = static_cast<int32_t>(mNodes.size());
+}
+
+void TransformStore::clear()
+{
+	for (size_t i = 0; i < mNodes.size(); i++)
+	{
+		if (mNodes[i] != nullptr)
+			unlink(static_cast<int32_t>(i));
+	}
+
+	mNodes.clear();
+	mParents.clear();
+	mEnds.clear();
+	mLocalX.clear();
+	mLocalY.clear();
+	mLocalT.clear();
+	mWorldX.clear();
+	mWorldY.clear();
+	mWorldT.clear();
+	mFlags.clear();
+	mVersions.clear();
+}
+
+void TransformStore::release(Node& node)
+{
+	if (node.mTransformStore != this || mNodes[node.mTransformIndex] != &node)
+		return;
+
+	auto index = node.mTransformIndex;
+
+	// detached subtree is contiguous range, its nodes go back to own matrices
+	for (int32_t i = index; i < mEnds[index]; i++)
+	{
+		if (mNodes[i] != nullptr)
+			unlink(i);
+	}
+}
+
+void TransformStore::unlink(int32_t index)
+{
+	auto node = mNodes[index];
+
+	// node keeps last world transform in its own matrix
+	node->mTransform = node->getTransform();
+	node->mTransformStore = nullptr;
+	node->mTransformIndex = -1;
+	mNodes[index] = nullptr;
+}
+
+void TransformStore::begin()
+{
+	for (auto& flags : mFlags)
+	{
+		flags &= Dirty;
+	}
+}
+
+void TransformStore::sweep()
+{
+	auto count = static_cast<int32_t>(mNodes.size());
+
+	for (int32_t i = 0; i < count; i++)
+	{
+		resolve(i);
+	}
+}
+
+void TransformStore::setLocal(int32_t index, const Affine& local)
+{
+	invalidateSubtree(index);
+	mLocalX[index] = local.x;
+	mLocalY[index] = local.y;
+	mLocalT[index] = local.t;
+	mFlags[index] |= Dirty;
+	mFlags[index] &= ~Overridden;
+}
+
+void TransformStore::setWorld(int32_t index, const Affine& world)
+{
+	invalidateSubtree(index);
+	mWorldX[index] = world.x;
+	mWorldY[index] = world.y;
+	mWorldT[index] = world.t;
+	mFlags[index] = Resolved | Changed | Overridden;
+	mVersions[index] += 1;
+}
+
+void TransformStore::resolve(int32_t index)
+{
+	auto& flags = mFlags[index];
+
+	if (flags & Resolved)
+		return;
+
+	auto parent = mParents[index];
+	bool parent_changed = false;
+
+	if (parent >= 0)
+	{
+		resolve(parent);
+		parent_changed = mFlags[parent] & Changed;
+	}
+
+	if (!(flags & Overridden) && ((flags & Dirty) || parent_changed))
+	{
+		auto local = Affine{ mLocalX[index], mLocalY[index], mLocalT[index] };
+		auto world = parent >= 0 ? Compose(getWorld(parent), local) : local;
+		mWorldX[index] = world.x;
+		mWorldY[index] = world.y;
+		mWorldT[index] = world.t;
+		mVersions[index] += 1;
+		flags |= Changed;
+	}
+
+	flags &= ~Dirty;
+	flags |= Resolved;
+}
+
+void TransformStore::forget(int32_t index)
+{
+	mNodes[index] = nullptr;
+}
+
+void TransformStore::invalidateSubtree(int32_t index)
+{
+	// resolving always goes through ancestors, so when slot isn't resolved yet, its subtree isn't either
+	if (!(mFlags[index] & Resolved))
+		return;
+
+	for (int32_t i = index; i < mEnds[index]; i++)
+	{
+		mFlags[i] &= ~Resolved;
+	}
+}
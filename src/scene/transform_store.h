@@ -0,0 +1,78 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <vector>
+
+namespace Scene
+{
+	class Node;
+
+	// optional flat storage of 2d world transforms, slots are in depth-first order,
+	// so parents always come before children and subtree of slot is contiguous range
+
+	class TransformStore
+	{
+	public:
+		struct Affine
+		{
+			glm::vec2 x = { 1.0f, 0.0f };
+			glm::vec2 y = { 0.0f, 1.0f };
+			glm::vec2 t = { 0.0f, 0.0f };
+		};
+
+		static Affine Compose(const Affine& parent, const Affine& local);
+		static Affine Inverse(const Affine& affine);
+		static glm::vec2 Apply(const Affine& affine, const glm::vec2& value);
+		static glm::mat4 ToMatrix(const Affine& affine);
+		static Affine FromMatrix(const glm::mat4& matrix);
+
+	public:
+		~TransformStore();
+
+	public:
+		void rebuild(Node& root);
+		void clear();
+		void release(Node& node);
+
+		void begin();
+		void sweep();
+
+		void setLocal(int32_t index, const Affine& local);
+		void setWorld(int32_t index, const Affine& world);
+		void resolve(int32_t index);
+		void forget(int32_t index);
+
+	public:
+		auto getSize() const { return mNodes.size(); }
+		auto getNode(int32_t index) const { return mNodes[index]; }
+		auto getVersion(int32_t index) const { return mVersions[index]; }
+		Affine getWorld(int32_t index) const { return { mWorldX[index], mWorldY[index], mWorldT[index] }; }
+
+	private:
+		void collect(Node& node, int32_t parent, const std::vector<Node*>& prev_nodes, std::vector<int32_t>& previous);
+		void unlink(int32_t index);
+		void invalidateSubtree(int32_t index);
+
+	private:
+		enum Flags : uint8_t
+		{
+			Dirty = 1 << 0, // local was changed
+			Resolved = 1 << 1, // world is final for current pass
+			Changed = 1 << 2, // world was recomputed in current pass
+			Overridden = 1 << 3 // world was set directly
+		};
+
+		std::vector<Node*> mNodes;
+		std::vector<int32_t> mParents;
+		std::vector<int32_t> mEnds; // end of subtree range
+		std::vector<glm::vec2> mLocalX;
+		std::vector<glm::vec2> mLocalY;
+		std::vector<glm::vec2> mLocalT;
+		std::vector<glm::vec2> mWorldX;
+		std::vector<glm::vec2> mWorldY;
+		std::vector<glm::vec2> mWorldT;
+		std::vector<uint8_t> mFlags;
+		std::vector<uint32_t> mVersions;
+	};
+}
@@ -0,0 +1,136 @@
+#include "virtual_list.h"
+
+using namespace Scene;
+
+void VirtualList::update(sky::Duration dTime)
+{
+	auto main_axis = mDirection == Direction::Vertical ? 1 : 0;
+	auto cross_axis = 1 - main_axis;
+	auto lines = (mItemsCount + mItemsInLine - 1) / mItemsInLine;
+
+	glm::vec2 size;
+	size[main_axis] = mItemSize[main_axis] * static_cast<float>(lines);
+	size[cross_axis] = mItemSize[cross_axis] * static_cast<float>(mItemsInLine);
+	setSize(size);
+
+	Node::update(dTime);
+
+	if (mRefreshNeeded)
+	{
+		for (size_t slot = 0; slot < mItems.size(); slot++)
+		{
+			unbind(slot);
+		}
+
+		mRefreshNeeded = false;
+	}
+
+	if (lines == 0 || mItemSize.x <= 0.0f || mItemSize.y <= 0.0f)
+	{
+		for (size_t slot = 0; slot < mItems.size(); slot++)
+		{
+			unbind(slot);
+		}
+
+		return;
+	}
+
+	// visible window in local space
+
+	auto window = Bounds{
+		.pos = { 0.0f, 0.0f },
+		.size = { static_cast<float>(PLATFORM->getWidth()), static_cast<float>(PLATFORM->getHeight()) }
+	};
+
+	if (auto scrollbox = mScrollbox.lock(); scrollbox != nullptr && scrollbox->getBounding()->isTransformReady())
+		window = scrollbox->getBounding()->getGlobalBounds();
+
+	auto tl = unproject(window.pos);
+	auto tr = unproject(window.pos + glm::vec2{ window.size.x, 0.0f });
+	auto bl = unproject(window.pos + glm::vec2{ 0.0f, window.size.y });
+	auto br = unproject(window.pos + window.size);
+
+	auto local_min = glm::min(glm::min(tl, tr), glm::min(bl, br));
+	auto local_max = glm::max(glm::max(tl, tr), glm::max(bl, br));
+
+	auto margin = static_cast<float>(mMarginLines);
+	auto first_line = glm::floor(local_min[main_axis] / mItemSize[main_axis]) - margin;
+	auto last_line = glm::floor(local_max[main_axis] / mItemSize[main_axis]) + margin;
+
+	first_line = glm::clamp(first_line, 0.0f, static_cast<float>(lines));
+	last_line = glm::clamp(last_line + 1.0f, first_line, static_cast<float>(lines));
+
+	auto begin = static_cast<size_t>(first_line) * mItemsInLine;
+	auto end = glm::min(static_cast<size_t>(last_line) * mItemsInLine, mItemsCount);
+
+	// release items that went out of view
+
+	mCovered.assign(end - begin, false);
+
+	for (size_t slot = 0; slot < mItems.size(); slot++)
+	{
+		const auto& index = mItemIndices[slot];
+
+		if (!index.has_value())
+			continue;
+
+		if (index.value() < begin || index.value() >= end)
+		{
+			unbind(slot);
+			continue;
+		}
+
+		mCovered[index.value() - begin] = true;
+	}
+
+	// bind recycled or new items to uncovered indices
+
+	for (auto index = begin; index < end; index++)
+	{
+		if (mCovered[index - begin])
+			continue;
+
+		size_t slot;
+
+		if (!mFreeSlots.empty())
+		{
+			slot = mFreeSlots.back();
+			mFreeSlots.pop_back();
+		}
+		else
+		{
+			slot = mItems.size();
+			auto item = mCreateItemCallback();
+			attach(item);
+			mItems.push_back(item);
+			mItemIndices.push_back(std::nullopt);
+		}
+
+		const auto& item = mItems[slot];
+
+		glm::vec2 pos;
+		pos[main_axis] = static_cast<float>(index / mItemsInLine) * mItemSize[main_axis];
+		pos[cross_axis] = static_cast<float>(index % mItemsInLine) * mItemSize[cross_axis];
+
+		item->setPosition(pos);
+		item->setSize(mItemSize);
+		item->setEnabled(true);
+
+		mItemIndices[slot] = index;
+		mActiveItemsCount += 1;
+
+		if (mBindItemCallback)
+			mBindItemCallback(item, index);
+	}
+}
+
+void VirtualList::unbind(size_t slot)
+{
+	if (!mItemIndices[slot].has_value())
+		return;
+
+	mItems[slot]->setEnabled(false);
+	mItemIndices[slot].reset();
+	mFreeSlots.push_back(slot);
+	mActiveItemsCount -= 1;
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <scene/node.h>
+#include <scene/scrollbox.h>
+#include <scene/node_pool.h>
+#include <optional>
+
+namespace Scene
+{
+	// list or grid of equally sized items, only items intersecting scrollbox bounding
+	// (plus margin lines) exist as nodes. item nodes are pooled, attached once and
+	// disabled when out of view, so scrolling never changes structure of the tree
+
+	class VirtualList : public Node
+	{
+	public:
+		enum class Direction
+		{
+			Vertical, // lines go down
+			Horizontal // lines go right
+		};
+
+		using CreateItemCallback = std::function<std::shared_ptr<Node>()>;
+		using BindItemCallback = std::function<void(std::shared_ptr<Node> item, size_t index)>;
+
+	protected:
+		void update(sky::Duration dTime) override;
+
+	public:
+		void refresh() { mRefreshNeeded = true; } // rebinds all visible items, call when data is changed
+
+		auto getActiveItemsCount() const { return mActiveItemsCount; }
+		auto getPoolSize() const { return mItems.size(); }
+
+	private:
+		void unbind(size_t slot);
+
+	public:
+		void setScrollbox(std::weak_ptr<Scrollbox> value) { mScrollbox = value; }
+
+		void setCreateItemCallback(CreateItemCallback value) { mCreateItemCallback = value; }
+		void setBindItemCallback(BindItemCallback value) { mBindItemCallback = value; }
+
+		auto getItemsCount() const { return mItemsCount; }
+		void setItemsCount(size_t value) { mItemsCount = value; }
+
+		auto getItemSize() const { return mItemSize; }
+		void setItemSize(const glm::vec2& value) { mItemSize = value; refresh(); }
+
+		auto getItemsInLine() const { return mItemsInLine; }
+		void setItemsInLine(size_t value) { mItemsInLine = glm::max<size_t>(value, 1); refresh(); }
+
+		auto getDirection() const { return mDirection; }
+		void setDirection(Direction value) { mDirection = value; refresh(); }
+
+		auto getMarginLines() const { return mMarginLines; }
+		void setMarginLines(size_t value) { mMarginLines = value; }
+
+	private:
+		std::weak_ptr<Scrollbox> mScrollbox;
+		CreateItemCallback mCreateItemCallback = [] { return MakePooled<Node>(); };
+		BindItemCallback mBindItemCallback = nullptr;
+		size_t mItemsCount = 0;
+		glm::vec2 mItemSize = { 32.0f, 32.0f };
+		size_t mItemsInLine = 1;
+		Direction mDirection = Direction::Vertical;
+		size_t mMarginLines = 1;
+		std::vector<std::shared_ptr<Node>> mItems;
+		std::vector<std::optional<size_t>> mItemIndices; // bound data index for every pooled item
+		std::vector<size_t> mFreeSlots;
+		std::vector<bool> mCovered;
+		size_t mActiveItemsCount = 0;
+		bool mRefreshNeeded = false;
+	};
+}
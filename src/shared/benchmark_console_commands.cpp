@@ -0,0 +1,690 @@
+#include "benchmark_console_commands.h"
+#include <sky/utils.h>
+#include <sky/clock.h>
+#include <sky/asset.h>
+#include <sky/text_mesh.h>
+#include <graphics/font.h>
+#include <scene/label.h>
+#include <scene/rectangle.h>
+#include <scene/node_pool.h>
+#include <scene/scene.h>
+#include <graphics/texture_pages.h>
+#include <magic_enum/magic_enum.hpp>
+#include <functional>
+#include <regex>
+#include <stack>
+
+using namespace Shared;
+
+// reference implementations, kept as they were before rewrites, test_* commands compare against them
+
+// line breaking before one pass layout, line is measured from its start after every symbol
+static float ReferenceStringWidth(const Graphics::Font& font, std::wstring::const_iterator begin,
+	std::wstring::const_iterator end, float size = Graphics::Font::GlyphSize)
+{
+	float result = 0.0f;
+
+	for (auto it = begin; it != end; ++it)
+	{
+		result += font.getGlyph(*it).xadvance;
+
+		if (it != end - 1)
+		{
+			result += font.getKerning(*it, *(it + 1));
+		}
+	}
+	return result * Graphics::Font::getScaleFactorForSize(size);
+}
+
+static std::vector<sky::TextMesh::Line> ReferenceCreateLines(const Graphics::Font& font, const std::wstring& text,
+	std::optional<float> maxWidth, float size)
+{
+	std::vector<sky::TextMesh::Line> result;
+
+	auto begin = text.begin();
+	auto end = text.end();
+	auto it = begin;
+
+	auto push_line = [&](std::wstring::const_iterator line_begin, std::wstring::const_iterator line_end) {
+		result.push_back({ static_cast<size_t>(line_begin - text.begin()), static_cast<size_t>(line_end - text.begin()),
+			ReferenceStringWidth(font, line_begin, line_end) });
+	};
+
+	while (it != end)
+	{
+		if (*it == '\n')
+		{
+			push_line(begin, it);
+			++it;
+			begin = it;
+			continue;
+		}
+
+		++it;
+
+		if (!maxWidth.has_value())
+			continue;
+
+		auto length = std::distance(begin, it);
+
+		if (length <= 1)
+			continue;
+
+		auto str_w = ReferenceStringWidth(font, begin, it, size);
+
+		if (str_w <= maxWidth.value())
+			continue;
+
+		--it;
+
+		auto best_it = it;
+
+		while (best_it != begin)
+		{
+			if (*best_it == ' ')
+			{
+				++best_it;
+				break;
+			}
+
+			--best_it;
+		}
+
+		if (best_it != begin)
+			it = best_it;
+
+		push_line(begin, it);
+		begin = it;
+	}
+
+	push_line(begin, end);
+
+	return result;
+}
+
+// label markup before tokenizer, every tag is matched by regex at string front
+static std::tuple<std::vector<glm::vec4>, std::wstring> ReferenceParseColorTags(std::wstring str)
+{
+	auto parse_u8_color = [](auto match) {
+		auto r = static_cast<uint8_t>(std::stoi(match[1]));
+		auto g = static_cast<uint8_t>(std::stoi(match[2]));
+		auto b = static_cast<uint8_t>(std::stoi(match[3]));
+		auto a = match.size() > 4 ? static_cast<uint8_t>(std::stoi(match[4])) : 255;
+		return sky::ColorToNormalized(r, g, b, a);
+	};
+
+	auto parse_float_color = [](auto match) {
+		auto r = std::stof(match[1]);
+		auto g = std::stof(match[2]);
+		auto b = std::stof(match[3]);
+		auto a = match.size() > 4 ? std::stof(match[4]) : 1.0f;
+		return glm::vec4{ r, g, b, a };
+	};
+
+	auto parse_hex_color = [](auto match) {
+		auto hex_color = match[1];
+		auto rgba = std::stoul(hex_color, nullptr, 16);
+		auto has_alpha = hex_color.length() == 8;
+		auto r = static_cast<uint8_t>((rgba >> (has_alpha ? 24 : 16)) & 0xFF);
+		auto g = static_cast<uint8_t>((rgba >> (has_alpha ? 16 : 8)) & 0xFF);
+		auto b = static_cast<uint8_t>((rgba >> (has_alpha ? 8 : 0)) & 0xFF);
+		auto a = static_cast<uint8_t>(has_alpha ? (rgba & 0xFF) : 255);
+		return sky::ColorToNormalized(r, g, b, a);
+	};
+
+	auto parse_named_color = [](auto match) {
+		auto str = sky::to_string(match[1].str());
+		auto type = magic_enum::enum_cast<sky::Color>(str, magic_enum::case_insensitive);
+
+		if (!type.has_value())
+			return sky::GetColor<glm::vec4>(sky::Color::White);
+
+		return sky::GetColor<glm::vec4>(type.value());
+	};
+
+	auto wregex = [](std::wstring expression) {
+		return std::wregex(expression, std::regex_constants::ECMAScript | std::regex_constants::icase);
+	};
+
+	std::vector<std::tuple<std::wregex, std::function<glm::vec4(std::wsmatch match)>>> color_tags = {
+		{ wregex(LR"(^<color=rgba\(\s*(\d+)\s*,\s*(\d+)\s*,\s*(\d+)\s*,\s*(\d+)\s*\)>)"), parse_u8_color },
+		{ wregex(LR"(^<color=rgb\(\s*(\d+)\s*,\s*(\d+)\s*,\s*(\d+)\s*\)>)"), parse_u8_color },
+		{ wregex(LR"(^<color=frgba\(\s*(\d+|\d+\.\d+)\s*,\s*(\d+|\d+\.\d+)\s*,\s*(\d+|\d+\.\d+)\s*,\s*(\d+|\d+\.\d+)\s*\)>)"), parse_float_color },
+		{ wregex(LR"(^<color=frgb\(\s*(\d+|\d+\.\d+)\s*,\s*(\d+|\d+\.\d+)\s*,\s*(\d+|\d+\.\d+)\s*\)>)"), parse_float_color },
+		{ wregex(LR"(^<color=hex\(\s*([0-9A-Fa-f]{6}|[0-9A-Fa-f]{8})\s*\)>)"), parse_hex_color },
+		{ wregex(LR"(^<color=\s*([A-Za-z]+)\s*>)"), parse_named_color },
+	};
+
+	std::wsmatch match;
+
+	std::stack<glm::vec4> color_stack;
+	color_stack.push({ 1.0f, 1.0f, 1.0f, 1.0f });
+
+	auto parse_color_push_tag = [&] {
+		for (const auto& [regex, callback] : color_tags)
+		{
+			if (std::regex_search(str, match, regex))
+			{
+				color_stack.push(callback(match));
+				str.erase(0, match.length());
+				return true;
+			}
+		}
+		return false;
+	};
+
+	auto pop_color_regex = wregex(LR"(^</color>)");
+	std::wstring result_text;
+	std::vector<glm::vec4> colormap;
+
+	while (!str.empty())
+	{
+		if (parse_color_push_tag())
+			continue;
+
+		if (std::regex_search(str, match, pop_color_regex))
+		{
+			if (color_stack.size() > 1) // originally popped unguarded, unbalanced closing tags keep base color now
+				color_stack.pop();
+
+			str.erase(0, match.length());
+		}
+		else
+		{
+			result_text.push_back(str.front());
+			str.erase(0, 1);
+			colormap.push_back(color_stack.top());
+		}
+	}
+
+	return { colormap, result_text };
+}
+
+static std::wstring ReferenceReplaceEscapedNewlines(const std::wstring& str)
+{
+	std::wregex pattern(LR"(\\n)");
+	return std::regex_replace(str, pattern, L"\n");
+}
+
+// depth is limited as in sky::UnfoldLocaleTags, originally recursion was unbounded on cyclic keys
+static std::wstring ReferenceUnfoldLocaleTags(const std::wstring& str, int depth = 16)
+{
+	std::wregex pattern(LR"(<loc=([^>]+)>)");
+	std::wstring result;
+	std::wsregex_iterator it(str.begin(), str.end(), pattern);
+	std::wsregex_iterator end;
+	size_t last_pos = 0;
+	for (; it != end; ++it)
+	{
+		const auto& match = *it;
+		result += str.substr(last_pos, match.position() - last_pos);
+		result += sky::Localize(sky::to_string(match[1].str()));
+		last_pos = match.position() + match.length();
+	}
+	result += str.substr(last_pos);
+	if (depth > 1 && std::regex_search(result, pattern))
+		return ReferenceUnfoldLocaleTags(result, depth - 1);
+	return result;
+}
+
+BenchmarkConsoleCommands::BenchmarkConsoleCommands()
+{
+	sky::AddCommand("bench_node_pool", "spawn and kill particles with default and pooled allocation",
+		{}, { { "count", "100000" } }, {}, [](int count) {
+		auto holder = std::make_shared<Scene::Node>();
+
+		auto measure = [&](auto make_particle) {
+			auto begin = sky::Now();
+			for (int i = 0; i < count; i++)
+			{
+				auto particle = make_particle();
+				holder->attach(particle);
+				holder->detach(particle);
+			}
+			return sky::ToSeconds(sky::Now() - begin) * 1000.0f;
+		};
+
+		auto shared_ms = measure([] { return std::make_shared<Scene::Rectangle>(); });
+		auto pooled_ms = measure([] { return Scene::MakePooled<Scene::Rectangle>(); });
+
+		sky::Log("{} particles, make_shared: {:.2f} ms, pooled: {:.2f} ms", count, shared_ms, pooled_ms);
+	});
+
+	sky::AddCommand("bench_font_load", "load font file and look up kerning of ascii pairs",
+		{ "path" }, { { "count", "10" } }, {}, [](std::string path, int count) {
+		auto asset = sky::Asset(path);
+		std::shared_ptr<Graphics::Font> font;
+
+		auto begin = sky::Now();
+		for (int i = 0; i < count; i++)
+		{
+			font = std::make_shared<Graphics::Font>(asset);
+		}
+		auto load_ms = sky::ToSeconds(sky::Now() - begin) * 1000.0f / static_cast<float>(count);
+
+		const auto& symbols = Graphics::Font::GetBasicLatinSymbols();
+		auto sum = 0.0f;
+
+		begin = sky::Now();
+		for (int i = 0; i < count; i++)
+		{
+			for (auto left : symbols)
+			{
+				for (auto right : symbols)
+				{
+					sum += font->getKerning(left, right);
+				}
+			}
+		}
+		auto lookups = symbols.size() * symbols.size() * count;
+		auto lookup_ns = sky::ToSeconds(sky::Now() - begin) * 1000000000.0f / static_cast<float>(lookups);
+
+		sky::Log("{}: load {:.2f} ms, {} kerning pairs, lookup {:.1f} ns (sum {})", path, load_ms,
+			font->getKerningPairsCount(), lookup_ns, sum);
+	});
+
+	sky::AddCommand("bench_text_mesh", "build text mesh of paragraph with default label font",
+		{}, { { "length", "10000" }, { "count", "10" }, { "width", "512" } }, {}, [](int length, int count, float width) {
+		auto font = Scene::Label::DefaultFont;
+
+		if (font == nullptr)
+		{
+			sky::Log("no default font");
+			return;
+		}
+
+		std::wstring text;
+		const auto& symbols = Graphics::Font::GetBasicLatinSymbols();
+
+		for (int i = 0; i < length; i++)
+		{
+			text.push_back(std::rand() % 6 == 0 ? L' ' : symbols[std::rand() % symbols.size()]);
+		}
+
+		size_t glyph_count = 0;
+
+		auto begin = sky::Now();
+		for (int i = 0; i < count; i++)
+		{
+			auto mesh = sky::TextMesh(*font, text, width, Scene::Label::DefaultFontSize, sky::TextMesh::Align::Left);
+			glyph_count = mesh.getGlyphs().size();
+		}
+		auto ms = sky::ToSeconds(sky::Now() - begin) * 1000.0f / static_cast<float>(count);
+
+		// what recorded draw keeps per glyph against quad it is expanded to
+		auto glyph_bytes = glyph_count * sizeof(sky::TextMesh::GlyphInstance);
+		auto quad_bytes = glyph_count * (4 * sizeof(sky::TextMesh::Vertices::value_type) +
+			6 * sizeof(sky::TextMesh::Indices::value_type));
+
+		sky::Log("{} symbols, wrapped at {}: {:.3f} ms per mesh", length, width, ms);
+		sky::Log("{} glyphs: {} bytes as instances, {} bytes as quads", glyph_count, glyph_bytes, quad_bytes);
+	});
+
+	sky::AddCommand("bench_label_updates", "refresh score label every frame, count reallocated mesh buffers",
+		{}, { { "frames", "1000" } }, {}, [](int frames) {
+		auto label = std::make_shared<Scene::Label>();
+
+		if (label->getFont() == nullptr)
+		{
+			sky::Log("no default font");
+			return;
+		}
+
+		std::wstring text = L"Score: 000000";
+
+		int reallocations = 0;
+		const void* glyphs_data = nullptr;
+
+		auto begin = sky::Now();
+		for (int i = 0; i < frames; i++)
+		{
+			for (int j = 0, value = i; j < 6; j++, value /= 10)
+			{
+				text[text.size() - 1 - j] = static_cast<wchar_t>(L'0' + (value % 10));
+			}
+
+			label->setText(text);
+			label->refresh();
+
+			auto data = static_cast<const void*>(label->getTextMesh()->getGlyphs().data());
+
+			if (i > 1 && data != glyphs_data) // first two frames build shared and then owned mesh
+				reallocations += 1;
+
+			glyphs_data = data;
+		}
+		auto us = sky::ToSeconds(sky::Now() - begin) * 1000000.0f / static_cast<float>(frames);
+
+		sky::Log("{} frames: {:.2f} us per refresh, {} reallocations of glyph buffer", frames, us, reallocations);
+	});
+
+	sky::AddCommand("bench_scene_draw", "draw subtrees of rectangles on offscreen scene serially and in parallel",
+		{}, { { "subtrees", "8" }, { "nodes", "5000" }, { "frames", "60" } }, {}, [](int subtrees, int nodes, int frames) {
+		Scene::Scene scene;
+		scene.getTimestepFixer().setEnabled(false);
+		scene.setParallelDrawEnabled(true);
+
+		// one target for all frames, command runs within single application frame
+		scene.setRenderTarget(GRAPHICS->getRenderTarget(512, 512));
+
+		std::vector<std::shared_ptr<Scene::Node>> roots;
+
+		for (int i = 0; i < subtrees; i++)
+		{
+			auto root = std::make_shared<Scene::Node>();
+			root->setStretch(1.0f);
+
+			for (int j = 0; j < nodes; j++)
+			{
+				auto rect = std::make_shared<Scene::Rectangle>();
+				rect->setSize(4.0f);
+				rect->setPosition({ static_cast<float>(std::rand() % 512), static_cast<float>(std::rand() % 512) });
+				root->attach(rect);
+			}
+
+			scene.getRoot()->attach(root);
+			roots.push_back(root);
+		}
+
+		auto measure = [&](bool parallel) {
+			for (auto& root : roots)
+			{
+				root->setParallelDraw(parallel);
+			}
+
+			auto begin = sky::Now();
+			for (int i = 0; i < frames; i++)
+			{
+				scene.frame();
+			}
+			return sky::ToSeconds(sky::Now() - begin) * 1000.0f / static_cast<float>(frames);
+		};
+
+		measure(false); // warm up command lists and transforms
+
+		auto serial_ms = measure(false);
+		auto parallel_ms = measure(true);
+
+		sky::Log("{} subtrees of {} nodes: serial {:.2f} ms, parallel {:.2f} ms per frame ({:.2f}x)", subtrees, nodes,
+			serial_ms, parallel_ms, serial_ms / parallel_ms);
+	});
+
+	sky::AddCommand("bench_scene_frame", "update and draw tree of rectangles on offscreen scene",
+		{}, { { "nodes", "50000" }, { "frames", "60" } }, {}, [](int nodes, int frames) {
+		Scene::Scene scene;
+		scene.getTimestepFixer().setEnabled(false);
+		scene.setRenderTarget(GRAPHICS->getRenderTarget(512, 512));
+
+		// groups of hundred keep tree a few levels deep like real screens
+		std::shared_ptr<Scene::Node> group;
+
+		for (int i = 0; i < nodes; i++)
+		{
+			if (i % 100 == 0)
+			{
+				group = std::make_shared<Scene::Node>();
+				group->setStretch(1.0f);
+				scene.getRoot()->attach(group);
+			}
+
+			auto rect = std::make_shared<Scene::Rectangle>();
+			rect->setSize(4.0f);
+			rect->setPosition({ static_cast<float>(std::rand() % 512), static_cast<float>(std::rand() % 512) });
+			group->attach(rect);
+		}
+
+		scene.frame(); // first frame computes all transforms
+
+		auto begin = sky::Now();
+		for (int i = 0; i < frames; i++)
+		{
+			scene.frame();
+		}
+		auto ms = sky::ToSeconds(sky::Now() - begin) * 1000.0f / static_cast<float>(frames);
+
+		sky::Log("{} nodes: {:.2f} ms per update and draw", scene.getNodesCount(), ms);
+	});
+
+	sky::AddCommand("bench_draw_rectangle", "draw rectangles through emitter, straight into batch and through scratch copy",
+		{}, { { "count", "100000" } }, {}, [](int count) {
+		auto target = GRAPHICS->getRenderTarget(512, 512);
+		auto color = sky::GetColor<glm::vec4>(sky::Color::White);
+
+		auto emit_rectangle = [&](auto vertex) {
+			vertex({ .pos = { 0.0f, 0.0f, 0.0f }, .color = color, .texcoord = { 0.0f, 0.0f } });
+			vertex({ .pos = { 0.0f, 1.0f, 0.0f }, .color = color, .texcoord = { 0.0f, 1.0f } });
+			vertex({ .pos = { 1.0f, 0.0f, 0.0f }, .color = color, .texcoord = { 1.0f, 0.0f } });
+			vertex({ .pos = { 1.0f, 1.0f, 0.0f }, .color = color, .texcoord = { 1.0f, 1.0f } });
+		};
+
+		auto measure = [&](auto draw_rectangle) {
+			GRAPHICS->begin();
+			GRAPHICS->pushRenderTarget(target);
+			GRAPHICS->pushOrthoMatrix(target);
+			auto begin = sky::Now();
+			for (int i = 0; i < count; i++)
+			{
+				draw_rectangle();
+			}
+			GRAPHICS->flushBatch();
+			auto ns = sky::ToSeconds(sky::Now() - begin) * 1000000000.0f / static_cast<float>(count);
+			GRAPHICS->pop(2);
+			GRAPHICS->end();
+			return ns;
+		};
+
+		// what emitted draws did before, vertices were gathered in scratch and copied into batch
+		skygfx::utils::Mesh::Vertices scratch_vertices;
+		skygfx::utils::Mesh::Indices scratch_indices = { 0, 1, 2, 2, 1, 3 };
+
+		auto scratch_ns = measure([&] {
+			scratch_vertices.clear();
+			emit_rectangle([&](const skygfx::utils::Mesh::Vertex& vertex) {
+				scratch_vertices.push_back(vertex);
+			});
+			GRAPHICS->draw(nullptr, nullptr, skygfx::Topology::TriangleList, scratch_vertices, scratch_indices);
+		});
+
+		auto batch_ns = measure([&] {
+			GRAPHICS->draw(nullptr, nullptr, skygfx::utils::MeshBuilder::Mode::TriangleStrip, emit_rectangle);
+		});
+
+		auto direct_ns = measure([&] {
+			GRAPHICS->drawRectangle(nullptr, color);
+		});
+
+		sky::Log("{} rectangles: through scratch {:.1f} ns, emitted to batch {:.1f} ns, drawRectangle {:.1f} ns",
+			count, scratch_ns, batch_ns, direct_ns);
+	});
+
+	sky::AddCommand("test_texture_pages", "pack random sizes into texture pages and check placements, no gpu is used",
+		{}, { { "count", "1000" }, { "seed", "1" } }, {}, [](int count, int seed) {
+		using Pages = Graphics::TexturePages;
+
+		std::srand(seed);
+
+		Pages pages;
+		std::vector<std::pair<Pages::Placement, glm::uvec2>> placed;
+		int rejected = 0;
+		int errors = 0;
+
+		for (int i = 0; i < count; i++)
+		{
+			auto size = glm::uvec2{ 1 + std::rand() % 160, 1 + std::rand() % 160 };
+			auto placement = Pages::Placement();
+
+			if (!pages.allocate(placement, size.x, size.y))
+			{
+				rejected += 1;
+				continue;
+			}
+
+			placed.push_back({ placement, size });
+		}
+
+		if (Pages::Placement oversized; pages.allocate(oversized, Pages::MaxTextureSize + 1, 1))
+		{
+			sky::Log("oversized texture was placed");
+			errors += 1;
+		}
+
+		size_t used_area = 0;
+
+		for (size_t i = 0; i < placed.size(); i++)
+		{
+			const auto& [placement, size] = placed[i];
+			auto min = placement.pos - Pages::Padding;
+			auto max = placement.pos + size + Pages::Padding;
+			used_area += static_cast<size_t>(size.x) * size.y;
+
+			if (placement.pos.x < Pages::Padding || placement.pos.y < Pages::Padding ||
+				max.x > Pages::PageSize || max.y > Pages::PageSize)
+			{
+				sky::Log("placement {} is out of page", i);
+				errors += 1;
+			}
+
+			if (placement.uv_offset != glm::vec2(placement.pos) / static_cast<float>(Pages::PageSize) ||
+				placement.uv_scale != glm::vec2(size) / static_cast<float>(Pages::PageSize))
+			{
+				sky::Log("placement {} has wrong texcoords", i);
+				errors += 1;
+			}
+
+			for (size_t j = 0; j < i; j++)
+			{
+				const auto& [other, other_size] = placed[j];
+
+				if (other.page != placement.page)
+					continue;
+
+				auto other_min = other.pos - Pages::Padding;
+				auto other_max = other.pos + other_size + Pages::Padding;
+
+				if (glm::all(glm::lessThan(min, other_max)) && glm::all(glm::lessThan(other_min, max)))
+				{
+					sky::Log("placements {} and {} overlap", j, i);
+					errors += 1;
+				}
+			}
+		}
+
+		auto pages_area = static_cast<float>(pages.getPages().size()) * Pages::PageSize * Pages::PageSize;
+		auto fill = pages_area > 0.0f ? static_cast<float>(used_area) / pages_area * 100.0f : 0.0f;
+
+		sky::Log("{} placed, {} rejected, {} pages, {:.1f}% filled, {} errors", placed.size(), rejected,
+			pages.getPages().size(), fill, errors);
+	});
+
+	sky::AddCommand("test_text_lines", "compare line breaking of text mesh with reference on random text",
+		{}, { { "count", "10000" }, { "seed", "1" } }, {}, [](int count, int seed) {
+		auto font = Scene::Label::DefaultFont;
+
+		if (font == nullptr)
+		{
+			sky::Log("no default font");
+			return;
+		}
+
+		std::srand(seed);
+
+		const auto& symbols = Graphics::Font::GetBasicLatinSymbols();
+		int mismatches = 0;
+
+		for (int i = 0; i < count; i++)
+		{
+			std::wstring text;
+			auto length = std::rand() % 200;
+
+			for (int j = 0; j < length; j++)
+			{
+				auto kind = std::rand() % 10;
+				text.push_back(kind == 0 ? L' ' : kind == 1 && std::rand() % 4 == 0 ? L'\n' : symbols[std::rand() % symbols.size()]);
+			}
+
+			auto size = 8.0f + static_cast<float>(std::rand() % 48);
+			auto max_width = std::rand() % 8 == 0 ? std::nullopt : std::optional<float>(static_cast<float>(std::rand() % 600));
+
+			auto expected = ReferenceCreateLines(*font, text, max_width, size);
+			const auto& lines = sky::TextMesh(*font, text, max_width, size, sky::TextMesh::Align::Left).getLines();
+
+			auto same = expected.size() == lines.size() && std::equal(expected.begin(), expected.end(), lines.begin(),
+				[](const auto& left, const auto& right) {
+					return left.begin == right.begin && left.end == right.end && left.width == right.width;
+				});
+
+			if (same)
+				continue;
+
+			if (mismatches < 5)
+				sky::Log("mismatch at width {}, size {}: \"{}\"", max_width.value_or(-1.0f), size, sky::to_string(text));
+
+			mismatches += 1;
+		}
+
+		sky::Log("{} texts, {} mismatches", count, mismatches);
+	});
+
+	sky::AddCommand("test_label_markup", "compare label markup passes with regex reference on random markup, then time both",
+		{}, { { "count", "10000" }, { "seed", "1" } }, {}, [](int count, int seed) {
+		static const std::vector<std::wstring> Pieces = { L"<color=", L"<COLOR=", L"rgba(", L"rgb(", L"frgba(", L"FRGB(",
+			L"hex(", L"</color>", L"</COLOR>", L"red", L"Green", L"bogus", L"aliceblue", L">", L")", L",", L" ", L"\t",
+			L"1", L"25", L"255", L"300", L"0.5", L"1.", L".5", L"ff00ff", L"FF00FF80", L"abc", L"1234567", L"a", L"x",
+			L"\\n", L"\\", L"n", L"<loc=", L"key", L"<", L"<loc=>", L"\n" };
+
+		std::srand(seed);
+
+		std::wstring text;
+		std::vector<glm::vec4> colormap;
+		int mismatches = 0;
+
+		for (int i = 0; i < count; i++)
+		{
+			std::wstring str;
+			auto length = std::rand() % 24;
+
+			for (int j = 0; j < length; j++)
+				str += Pieces[std::rand() % Pieces.size()];
+
+			Scene::Label::ParseColorTags(str, text, colormap);
+			auto [expected_colormap, expected_text] = ReferenceParseColorTags(str);
+
+			auto same = text == expected_text && colormap == expected_colormap &&
+				Scene::Label::ReplaceEscapedNewlines(str) == ReferenceReplaceEscapedNewlines(str) &&
+				sky::UnfoldLocaleTags(str) == ReferenceUnfoldLocaleTags(str);
+
+			if (same)
+				continue;
+
+			if (mismatches < 5)
+				sky::Log("mismatch: \"{}\"", sky::to_string(str));
+
+			mismatches += 1;
+		}
+
+		sky::Log("{} strings, {} mismatches", count, mismatches);
+
+		std::wstring markup;
+
+		for (int i = 0; i < 50; i++)
+			markup += L"Score <color=rgba(255, 200, 0, 255)>1234</color> and <color=hex(FF00FF)>bonus <color=red>x2</color></color> line\\n";
+
+		auto measure = [&](auto func) {
+			constexpr int Repeats = 100;
+			auto begin = sky::Now();
+			for (int i = 0; i < Repeats; i++)
+				func();
+			return sky::ToSeconds(sky::Now() - begin) * 1000000.0f / static_cast<float>(Repeats);
+		};
+
+		auto regex_us = measure([&] {
+			ReferenceParseColorTags(ReferenceReplaceEscapedNewlines(markup));
+		});
+
+		auto tokenizer_us = measure([&] {
+			Scene::Label::ParseColorTags(Scene::Label::ReplaceEscapedNewlines(markup), text, colormap);
+		});
+
+		sky::Log("{} symbols of markup, regex: {:.1f} us, tokenizer: {:.1f} us", markup.size(), regex_us, tokenizer_us);
+	});
+}
@@ -0,0 +1,13 @@
+#pragma once
+
+namespace Shared
+{
+	// console commands measuring engine subsystems on live data and checking them
+	// against reference implementations (test_*), results are printed to console
+
+	class BenchmarkConsoleCommands
+	{
+	public:
+		BenchmarkConsoleCommands();
+	};
+}
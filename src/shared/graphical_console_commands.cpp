@@ -4,6 +4,7 @@
 #include <sky/console.h>
 #include <sky/utils.h>
 #include <common/console_commands.h>
+#include <sky/renderer.h>
 
 using namespace Shared;
 
@@ -16,6 +17,32 @@ GraphicalConsoleCommands::GraphicalConsoleCommands()
 	sky::AddCommand("rescale", "smart scaling", { "float" }, {}, {}, [](float value) {
 		PLATFORM->rescale(value);
 	});
+
+	sky::AddCommand("r_target_pool_stats", "show render target pool usage", {}, {}, {}, [] {
+		const auto& pool = GRAPHICS->getRenderTargetPool();
+		const auto& stats = pool.getFrameStats();
+		sky::Log("targets: {}, leased: {}, allocations: {}, reuses: {}, evictions: {}, memory: {} of {} kb",
+			stats.targets, stats.leased, stats.allocations, stats.reuses, stats.evictions,
+			stats.bytes / 1024, pool.getBudget() / 1024);
+	});
+
+	sky::AddCommand("r_texture_pages_stats", "show usage of shared texture pages", {}, {}, {}, [] {
+		const auto& pages = GRAPHICS->getTexturePages();
+		sky::Log("registered textures: {}, pages: {}", pages.getPlacementsCount(), pages.getPages().size());
+		for (const auto& page : pages.getPages())
+		{
+			sky::Log("page: {} textures, {} of {} rows used", page.placements, page.height, Graphics::TexturePages::PageSize);
+		}
+	});
+
+	sky::AddCommand("r_recorder_stats", "show counters of headless command recorder", {}, {}, {}, [] {
+		if (!RENDERER->isHeadless())
+		{
+			sky::Log("renderer is not headless");
+			return;
+		}
+		sky::Log(RENDERER->getRecorder()->dump());
+	});
 }
 
 void GraphicalConsoleCommands::onFrame()
@@ -23,12 +50,11 @@ void GraphicalConsoleCommands::onFrame()
 	if (mShowTargets)
 	{
 		ImGui::Begin("Render Targets");
-		for (const auto& [name, target] : GRAPHICS->getRenderTargets())
+		for (const auto& entry : GRAPHICS->getRenderTargetPool().getEntries())
 		{
-			ImGui::Text("%s", name.c_str());
-			ImGui::Text("%dx%d", target->getWidth(), target->getHeight());
+			ImGui::Text("%dx%d%s", entry.width, entry.height, entry.leased ? " (leased)" : "");
 			auto width = ImGui::GetContentRegionAvail().x;
-			SceneEditor::drawImage(target, std::nullopt, width);
+			SceneEditor::drawImage(entry.target, std::nullopt, width);
 			ImGui::Separator();
 		}
 		ImGui::End();
@@ -25,6 +25,11 @@ namespace Shared
 			std::bind(&Graphics::System::isBatching, GRAPHICS),
 			std::bind(&Graphics::System::setBatching, GRAPHICS, std::placeholders::_1));
 
+		sky::CVar<bool> mTexturePaging = sky::CVar<bool>("r_texture_pages",
+			std::bind(&Graphics::System::isTexturePaging, GRAPHICS),
+			std::bind(&Graphics::System::setTexturePaging, GRAPHICS, std::placeholders::_1),
+			"merge batches of small static textures through shared pages");
+
 		sky::CVar<float> mScale = sky::CVar<float>("r_scale",
 			std::bind(&Platform::System::getScale, PLATFORM),
 			std::bind(&Platform::System::setScale, PLATFORM, std::placeholders::_1),
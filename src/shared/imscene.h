@@ -39,7 +39,7 @@ namespace Shared
 			mFirstCall = result == nullptr;
 			if (result == nullptr)
 			{
-				result = std::make_shared<T>(args...);
+				result = Scene::MakePooled<T>(args...);
 				target.attach(result);
 				auto item = NodeItem(result, [result] {
 					if (result->hasParent())
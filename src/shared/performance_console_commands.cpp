@@ -9,6 +9,8 @@
 #include <common/helpers.h>
 #include <graphics/system.h>
 #include <sky/threadpool.h>
+#include <scene/scene.h>
+#include <sky/text_mesh_cache.h>
 
 using namespace Shared;
 
@@ -60,7 +62,33 @@ void PerformanceConsoleCommands::onFrame()
 	}
 
 	if (mWantShowTargets > 0)
-		sky::Indicator("engine", "targets", GRAPHICS->getRenderTargets().size());
+		sky::Indicator("engine", "targets", GRAPHICS->getRenderTargetPool().getEntries().size());
+
+	if (mWantShowNodes > 0 && sky::Locator<Scene::Scene>::Exists())
+	{
+		auto scene = sky::GetService<Scene::Scene>();
+		sky::Indicator("engine", "nodes drawn", scene->getDrawnNodesCount());
+		sky::Indicator("engine", "nodes culled", scene->getCulledNodesCount());
+	}
+
+	if (mWantShowTextCache > 0 && sky::Locator<sky::TextMeshCache>::Exists())
+	{
+		auto hits = TEXT_MESH_CACHE->getHits();
+		auto total = hits + TEXT_MESH_CACHE->getMisses();
+		auto rate = total > 0 ? (hits * 100 / total) : 0;
+		sky::Indicator("engine", "text cache", fmt::format("{}% ({} of {})", rate, hits, total));
+		sky::Indicator("engine", "text cache size", fmt::format("{} meshes, {}", TEXT_MESH_CACHE->getEntriesCount(),
+			Common::Helpers::BytesToNiceString(TEXT_MESH_CACHE->getMemoryUsage())));
+	}
+
+	if (mWantShowDrawCache > 0 && sky::Locator<Scene::Scene>::Exists())
+	{
+		auto scene = sky::GetService<Scene::Scene>();
+		auto hits = scene->getDrawCacheHits();
+		auto total = hits + scene->getDrawCacheMisses();
+		auto rate = total > 0 ? (hits * 100 / total) : 0;
+		sky::Indicator("engine", "draw cache", fmt::format("{}% ({} of {})", rate, hits, total));
+	}
 
 	if (mWantShowThreadpool > 1)
 		sky::Indicator("engine", "threadpool", std::to_string(THREADPOOL->getTasksCount()) + " at " + std::to_string(THREADPOOL->getThreadsCount()) + " threads");
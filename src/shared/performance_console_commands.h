@@ -4,6 +4,7 @@
 #include <sky/console.h>
 #include <platform/system.h>
 #include <common/framerate_counter.h>
+#include <sky/text_mesh_cache.h>
 #include <deque>
 
 namespace Shared
@@ -21,8 +22,17 @@ namespace Shared
 		sky::CVar<int> mWantShowDrawcalls = sky::CVar<int>("hud_show_drawcalls", 0, "show drawcalls statistics");
 		sky::CVar<int> mWantShowBatches = sky::CVar<int>("hud_show_batches", 0, "show batches statistics");
 		sky::CVar<int> mWantShowTargets = sky::CVar<int>("hud_show_targets", 0, "show render targets statistics");
+		sky::CVar<int> mWantShowNodes = sky::CVar<int>("hud_show_nodes", 0, "show drawn and culled scene nodes");
+		sky::CVar<int> mWantShowTextCache = sky::CVar<int>("hud_show_text_cache", 0, "show hit rate and memory of shared text meshes");
+		sky::CVar<int> mWantShowDrawCache = sky::CVar<int>("hud_show_draw_cache", 0, "show hit rate of retained scene draw lists");
 		sky::CVar<int> mWantShowThreadpool = sky::CVar<int>("hud_show_threadpool", 0, "show threadpool tasks on screen");
 		sky::CVar<int> mWantShowTasks = sky::CVar<int>("hud_show_tasks", 0, "show tasks on screen");
+
+		sky::CVar<int> mTextMeshCacheBudget = sky::CVar<int>("text_mesh_cache_budget",
+			[] { return static_cast<int>(TEXT_MESH_CACHE->getBudget() / 1024); },
+			[](int value) { TEXT_MESH_CACHE->setBudget(static_cast<size_t>(glm::max(value, 0)) * 1024); },
+			"memory budget of shared text meshes in kilobytes");
+
 #ifndef EMSCRIPTEN
 		sky::CVar<bool> mWantShowNetSpeed = sky::CVar<bool>("hud_show_net_speed", false);
 		sky::CVar<bool> mWantShowNetPps = sky::CVar<bool>("hud_show_net_pps", false);
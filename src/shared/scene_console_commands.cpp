@@ -0,0 +1,34 @@
+#include "scene_console_commands.h"
+#include <scene/node_pool.h>
+#include <sky/utils.h>
+
+using namespace Shared;
+
+SceneConsoleCommands::SceneConsoleCommands(Scene::Scene& scene) :
+	mParallelDraw("scene_parallel_draw",
+		std::bind(&Scene::Scene::isParallelDrawEnabled, &scene),
+		std::bind(&Scene::Scene::setParallelDrawEnabled, &scene, std::placeholders::_1)),
+	mParallelUpdate("scene_parallel_update",
+		std::bind(&Scene::Scene::isParallelUpdateEnabled, &scene),
+		std::bind(&Scene::Scene::setParallelUpdateEnabled, &scene, std::placeholders::_1)),
+	mFlatTransforms("scene_flat_transforms",
+		std::bind(&Scene::Scene::isFlatTransformsEnabled, &scene),
+		std::bind(&Scene::Scene::setFlatTransformsEnabled, &scene, std::placeholders::_1)),
+	mHitGrid("scene_hit_grid",
+		std::bind(&Scene::Scene::isHitGridEnabled, &scene),
+		std::bind(&Scene::Scene::setHitGridEnabled, &scene, std::placeholders::_1)),
+	mCulling("scene_culling",
+		std::bind(&Scene::Scene::isCullingEnabled, &scene),
+		std::bind(&Scene::Scene::setCullingEnabled, &scene, std::placeholders::_1)),
+	mDrawCache("scene_draw_cache",
+		std::bind(&Scene::Scene::isDrawCacheEnabled, &scene),
+		std::bind(&Scene::Scene::setDrawCacheEnabled, &scene, std::placeholders::_1))
+{
+	sky::AddCommand("scene_node_pool_stats", "show usage of pooled node allocations", {}, {}, {}, [] {
+		for (const auto& stats : Scene::SlabPool::GetStats())
+		{
+			sky::Log("block: {} bytes, slabs: {}, used: {}, free: {}", stats.block_size, stats.slabs,
+				stats.used_blocks, stats.free_blocks);
+		}
+	});
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <sky/console.h>
+#include <scene/scene.h>
+
+namespace Shared
+{
+	class SceneConsoleCommands
+	{
+	public:
+		SceneConsoleCommands(Scene::Scene& scene);
+
+	private:
+		sky::CVar<bool> mParallelDraw;
+		sky::CVar<bool> mParallelUpdate;
+		sky::CVar<bool> mFlatTransforms;
+		sky::CVar<bool> mHitGrid;
+		sky::CVar<bool> mCulling;
+		sky::CVar<bool> mDrawCache;
+	};
+}
@@ -124,9 +124,10 @@ void SceneEditor::showRecursiveNodeTree(std::shared_ptr<Scene::Node> node)
 
 	if (opened)
 	{
-		for (auto _node : node->getNodes())
+		for (const auto& _node : node->getNodes())
 		{
-			showRecursiveNodeTree(_node);
+			if (_node != nullptr)
+				showRecursiveNodeTree(_node);
 		}
 
 		ImGui::TreePop();
@@ -181,9 +182,16 @@ void SceneEditor::showNodeEditor(std::shared_ptr<Scene::Node> node)
 
 		ImGui::Separator();
 
-		if (auto texture = label->getFont()->getTexture(); texture != nullptr)
+		const auto& font = label->getFont();
+
+		for (uint32_t page = 0; page < font->getPagesCount(); page++)
 		{
-			ImGui::Text("%dx%d", texture->getWidth(), texture->getHeight());
+			auto texture = font->getTexture(page);
+
+			if (texture == nullptr)
+				continue;
+
+			ImGui::Text("page %d, %dx%d", page, texture->getWidth(), texture->getHeight());
 			drawImage(texture);
 			ImGui::Separator();
 		}
@@ -71,9 +71,10 @@ std::shared_ptr<Scene::Node> SceneHelpers::MakeWeightedColumn(const std::vector<
 
 void SceneHelpers::RecursiveColorSet(std::shared_ptr<Scene::Node> node, const glm::vec4& color)
 {
-	for (auto child : node->getNodes())
+	for (const auto& child : node->getNodes())
 	{
-		RecursiveColorSet(child, color);
+		if (child != nullptr)
+			RecursiveColorSet(child, color);
 	}
 
 	auto color_node = std::dynamic_pointer_cast<Scene::Color>(node);
@@ -86,9 +87,10 @@ void SceneHelpers::RecursiveColorSet(std::shared_ptr<Scene::Node> node, const gl
 
 void SceneHelpers::RecursiveAlphaSet(std::shared_ptr<Scene::Node> node, float alpha)
 {
-	for (auto child : node->getNodes())
+	for (const auto& child : node->getNodes())
 	{
-		RecursiveAlphaSet(child, alpha);
+		if (child != nullptr)
+			RecursiveAlphaSet(child, alpha);
 	}
 
 	auto color_node = std::dynamic_pointer_cast<Scene::Color>(node);
@@ -120,6 +120,11 @@ namespace Shared::SceneHelpers
 	{
 		static_assert(std::is_base_of<Scene::Node, T>::value, "T must be derived from Node");
 	public:
+		bool isTransformDirty() const override
+		{
+			return true; // relative scale is animated
+		}
+
 		void updateTransform() override
 		{
 			T::updateTransform();
@@ -8,6 +8,7 @@
 #include <regex>
 #include <sky/locator.h>
 #include <sky/cache.h>
+#include <sky/text_mesh_cache.h>
 #include <sky/localization.h>
 #include <sky/renderer.h>
 #include <sky/dispatcher.h>
@@ -36,7 +37,11 @@ Application::Application(const std::string& appname, const Flags& flags, std::op
 	sky::Locator<sky::CommandProcessor>::Init();
 	sky::Locator<sky::Scheduler>::Init();
 	sky::Locator<Platform::System>::Set(Platform::System::create(appname));
+#ifdef PLATFORM_HEADLESS
+	sky::Locator<sky::Renderer>::Init(std::make_shared<sky::CommandRecorder>());
+#else
 	sky::Locator<sky::Renderer>::Init(backend_type);
+#endif
 	sky::Locator<sky::Console>::Set(std::make_shared<sky::ImguiConsole>());
 	sky::Locator<Graphics::System>::Init();
 	if (flags.count(Flag::Network))
@@ -48,6 +53,8 @@ Application::Application(const std::string& appname, const Flags& flags, std::op
 	sky::Locator<sky::Localization>::Init();
 	sky::Locator<Shared::StatsSystem>::Init();
 	sky::Locator<sky::Cache>::Init();
+	sky::Locator<sky::TextMeshCache>::Init();
+
 	sky::Locator<sky::ImguiSystem>::Init();
 	sky::Locator<Shared::Stylebook>::Init();
 	sky::Locator<Shared::ImScene>::Init();
@@ -59,6 +66,7 @@ Application::Application(const std::string& appname, const Flags& flags, std::op
 	sky::Locator<Shared::GraphicalConsoleCommands>::Init();
 	sky::Locator<Shared::PerformanceConsoleCommands>::Init();
 	sky::Locator<Shared::ConsoleHelperCommands>::Init();
+	sky::Locator<Shared::BenchmarkConsoleCommands>::Init();
 	sky::Locator<Shared::TouchEmulator>::Init();
 	sky::Locator<Shared::GestureDetector>::Init();
 
@@ -84,6 +92,7 @@ Application::Application(const std::string& appname, const Flags& flags, std::op
 				&& !ImGui::IsAnyItemActive();
 		});
 		sky::Locator<Shared::SceneEditor>::Init(*scene);
+		sky::Locator<Shared::SceneConsoleCommands>::Init(*scene);
 
 		sky::Locator<Shared::SceneManager>::Init();
 		scene->getRoot()->attach(sky::GetService<Shared::SceneManager>());
@@ -211,6 +220,7 @@ Application::~Application()
 	gCVarSceneTimestepTimeCompletion.reset();
 	sky::Locator<Shared::GestureDetector>::Reset();
 	sky::Locator<Shared::TouchEmulator>::Reset();
+	sky::Locator<Shared::BenchmarkConsoleCommands>::Reset();
 	sky::Locator<Shared::ConsoleHelperCommands>::Reset();
 	sky::Locator<Shared::PerformanceConsoleCommands>::Reset();
 	sky::Locator<Shared::GraphicalConsoleCommands>::Reset();
@@ -218,6 +228,7 @@ Application::~Application()
 	if (mFlags.count(Flag::Scene))
 	{
 		sky::Locator<Shared::SceneManager>::Reset();
+		sky::Locator<Shared::SceneConsoleCommands>::Reset();
 		sky::Locator<Shared::SceneEditor>::Reset();
 		sky::Locator<Scene::Scene>::Reset();
 	}
@@ -225,6 +236,7 @@ Application::~Application()
 	sky::Locator<Shared::ImScene>::Reset();
 	sky::Locator<Shared::Stylebook>::Reset();
 	sky::Locator<sky::ImguiSystem>::Reset();
+	sky::Locator<sky::TextMeshCache>::Reset();
 	sky::Locator<sky::Cache>::Reset();
 	if (mFlags.count(Flag::Audio))
 	{
@@ -8,6 +8,8 @@
 #include <shared/graphical_console_commands.h>
 #include <shared/performance_console_commands.h>
 #include <shared/console_helper_commands.h>
+#include <shared/benchmark_console_commands.h>
+#include <shared/scene_console_commands.h>
 #include <shared/stats_system.h>
 #include <shared/touch_emulator.h>
 #include <shared/gesture_detector.h>
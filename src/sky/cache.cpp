@@ -3,6 +3,7 @@
 #include <common/helpers.h>
 #include <sky/utils.h>
 #include <sky/asset.h>
+#include <sky/renderer.h>
 
 Graphics::TexturePart sky::Cache::getTexture(const std::string& name)
 {
@@ -71,9 +72,18 @@ void sky::Cache::loadTexture(const Graphics::Image& image, const std::string& na
 
 	assert(image.getChannels() == 4); // TODO: skygfx::Format::Byte(1/2/3)
 
+	if (sky::Locator<sky::Renderer>::Exists() && RENDERER->isHeadless())
+	{
+		loadTexture(nullptr, name); // sprites draw untextured, image is not uploaded
+		return;
+	}
+
 	auto texture = std::make_shared<skygfx::Texture>(image.getWidth(), image.getHeight(),
 		skygfx::PixelFormat::RGBA8UNorm, image.getMemory());
 
+	if (sky::Locator<Graphics::System>::Exists())
+		GRAPHICS->addPageableTexture(texture);
+
 	loadTexture(texture, name);
 }
 
@@ -102,7 +112,27 @@ void sky::Cache::loadFont(const std::string& path, std::optional<std::string> _n
 	if (mFonts.count(name) > 0)
 		return;
 
-	mFonts[name] = std::make_shared<Graphics::Font>(path);
+	auto asset = sky::Asset(path);
+
+	// precompiled font is keyed by font data and generation parameters, so stale files are never matched
+	auto cache_path = fmt::format("font_{:08x}.cache", Graphics::Font::GetCacheKey(asset.getMemory(), asset.getSize()));
+	auto storage = sky::Asset::Storage::Bundle;
+
+	std::shared_ptr<Graphics::Font> font;
+
+	if (sky::Asset::Exists(cache_path, storage))
+		font = std::make_shared<Graphics::Font>(asset, sky::Asset(cache_path, storage));
+	else
+		font = std::make_shared<Graphics::Font>(asset);
+
+	if (!font->isLoadedFromCache())
+	{
+		auto buf = sky::BitBuffer();
+		font->writeCache(buf);
+		sky::Asset::Write(cache_path, buf.getMemory(), buf.getSize(), storage);
+	}
+
+	mFonts[name] = font;
 }
 
 void sky::Cache::loadSound(std::shared_ptr<Audio::Sound> sound, const std::string& name)
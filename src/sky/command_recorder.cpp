@@ -0,0 +1,124 @@
+#include "command_recorder.h"
+#include <fmt/format.h>
+#include <type_traits>
+#include <variant>
+
+using namespace sky;
+
+template <typename T>
+static const char* GetCommandName()
+{
+	namespace cmds = skygfx::utils::commands;
+
+	if constexpr (std::is_same_v<T, cmds::SetEffect>) return "SetEffect";
+	else if constexpr (std::is_same_v<T, cmds::SetTopology>) return "SetTopology";
+	else if constexpr (std::is_same_v<T, cmds::SetViewport>) return "SetViewport";
+	else if constexpr (std::is_same_v<T, cmds::SetScissor>) return "SetScissor";
+	else if constexpr (std::is_same_v<T, cmds::SetBlendMode>) return "SetBlendMode";
+	else if constexpr (std::is_same_v<T, cmds::SetSampler>) return "SetSampler";
+	else if constexpr (std::is_same_v<T, cmds::SetCullMode>) return "SetCullMode";
+	else if constexpr (std::is_same_v<T, cmds::SetTextureAddress>) return "SetTextureAddress";
+	else if constexpr (std::is_same_v<T, cmds::SetDepthMode>) return "SetDepthMode";
+	else if constexpr (std::is_same_v<T, cmds::SetStencilMode>) return "SetStencilMode";
+	else if constexpr (std::is_same_v<T, cmds::SetMipmapBias>) return "SetMipmapBias";
+	else if constexpr (std::is_same_v<T, cmds::SetMesh>) return "SetMesh";
+	else if constexpr (std::is_same_v<T, cmds::SetColorTexture>) return "SetColorTexture";
+	else if constexpr (std::is_same_v<T, cmds::SetProjectionMatrix>) return "SetProjectionMatrix";
+	else if constexpr (std::is_same_v<T, cmds::SetViewMatrix>) return "SetViewMatrix";
+	else if constexpr (std::is_same_v<T, cmds::SetModelMatrix>) return "SetModelMatrix";
+	else if constexpr (std::is_same_v<T, cmds::DrawMesh>) return "DrawMesh";
+	else return "Command";
+}
+
+void CommandRecorder::execute(const std::vector<skygfx::utils::Command>& cmds, uint32_t vertex_count, uint32_t index_count)
+{
+	for (const auto& cmd : cmds)
+	{
+		std::visit([&](const auto& value) {
+			using T = std::decay_t<decltype(value)>;
+
+			mCounters.commands += 1;
+
+			if constexpr (std::is_same_v<T, skygfx::utils::commands::DrawMesh>)
+			{
+				mCounters.draws += 1;
+				mCounters.vertices += vertex_count;
+				mCounters.indices += index_count;
+				mCounters.bytes_uploaded += (vertex_count * sizeof(skygfx::utils::Mesh::Vertex)) +
+					(index_count * sizeof(skygfx::utils::Mesh::Index));
+				if (mLogEnabled)
+					mLog.push_back(fmt::format("{} vertices={} indices={}", GetCommandName<T>(), vertex_count, index_count));
+			}
+			else if (mLogEnabled)
+			{
+				mLog.push_back(GetCommandName<T>());
+			}
+		}, cmd);
+	}
+}
+
+void CommandRecorder::setRenderTarget(const skygfx::RenderTarget* target)
+{
+	mCounters.target_changes += 1;
+
+	if (!mLogEnabled)
+		return;
+
+	if (target == nullptr)
+		mLog.push_back("SetRenderTarget backbuffer");
+	else
+		mLog.push_back(fmt::format("SetRenderTarget {}x{}", target->getWidth(), target->getHeight()));
+}
+
+void CommandRecorder::clear(std::optional<glm::vec4> color, std::optional<float> depth, std::optional<uint8_t> stencil)
+{
+	mCounters.clears += 1;
+
+	if (mLogEnabled)
+		mLog.push_back(fmt::format("Clear color={} depth={} stencil={}", color.has_value(), depth.has_value(), stencil.has_value()));
+}
+
+void CommandRecorder::stateChanged()
+{
+	mCounters.state_changes += 1;
+}
+
+void CommandRecorder::present()
+{
+	if (mLogEnabled)
+		mLog.push_back(fmt::format("Present {}", mFrameCount));
+
+	mTotalCounters.commands += mCounters.commands;
+	mTotalCounters.draws += mCounters.draws;
+	mTotalCounters.state_changes += mCounters.state_changes;
+	mTotalCounters.target_changes += mCounters.target_changes;
+	mTotalCounters.clears += mCounters.clears;
+	mTotalCounters.vertices += mCounters.vertices;
+	mTotalCounters.indices += mCounters.indices;
+	mTotalCounters.bytes_uploaded += mCounters.bytes_uploaded;
+
+	mFrameCounters = mCounters;
+	mCounters = {};
+	mFrameCount += 1;
+}
+
+void CommandRecorder::reset()
+{
+	mLog.clear();
+	mCounters = {};
+	mFrameCounters = {};
+	mTotalCounters = {};
+	mFrameCount = 0;
+}
+
+std::string CommandRecorder::dump() const
+{
+	auto format_counters = [](const Counters& counters) {
+		return fmt::format("commands: {}, draws: {}, state changes: {}, target changes: {}, clears: {}, "
+			"vertices: {}, indices: {}, bytes uploaded: {}", counters.commands, counters.draws, counters.state_changes,
+			counters.target_changes, counters.clears, counters.vertices, counters.indices, counters.bytes_uploaded);
+	};
+
+	return fmt::format("frames: {}\nlast frame: {}\ntotal: {}", mFrameCount, format_counters(mFrameCounters),
+		format_counters(mTotalCounters));
+}
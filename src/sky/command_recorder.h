@@ -0,0 +1,57 @@
+#pragma once
+
+#include <skygfx/skygfx.h>
+#include <skygfx/utils.h>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace sky
+{
+	// records the command stream of Graphics::System instead of executing it on gpu,
+	// used by headless renderer to measure cpu-side rendering cost without device
+
+	class CommandRecorder
+	{
+	public:
+		struct Counters
+		{
+			int commands = 0;
+			int draws = 0;
+			int state_changes = 0;
+			int target_changes = 0;
+			int clears = 0;
+			size_t vertices = 0;
+			size_t indices = 0;
+			size_t bytes_uploaded = 0;
+		};
+
+	public:
+		void execute(const std::vector<skygfx::utils::Command>& cmds, uint32_t vertex_count, uint32_t index_count);
+		void setRenderTarget(const skygfx::RenderTarget* target);
+		void clear(std::optional<glm::vec4> color, std::optional<float> depth, std::optional<uint8_t> stencil);
+		void stateChanged();
+		void present();
+		void reset();
+
+		std::string dump() const;
+
+	public:
+		const auto& getLog() const { return mLog; }
+		const auto& getCounters() const { return mCounters; }
+		const auto& getFrameCounters() const { return mFrameCounters; }
+		const auto& getTotalCounters() const { return mTotalCounters; }
+		auto getFrameCount() const { return mFrameCount; }
+
+		bool isLogEnabled() const { return mLogEnabled; }
+		void setLogEnabled(bool value) { mLogEnabled = value; }
+
+	private:
+		std::vector<std::string> mLog;
+		bool mLogEnabled = false;
+		Counters mCounters; // current frame
+		Counters mFrameCounters; // last presented frame
+		Counters mTotalCounters;
+		uint64_t mFrameCount = 0;
+	};
+}
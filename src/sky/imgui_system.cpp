@@ -5,6 +5,7 @@
 #include <graphics/all.h>
 #include <sky/console.h>
 #include <common/console_commands.h>
+#include <sky/renderer.h>
 
 using namespace sky;
 
@@ -158,6 +159,13 @@ void ImguiSystem::ensureFont()
 	int32_t height;
 
 	io.Fonts->GetTexDataAsRGBA32(&data, &width, &height);
+
+	if (RENDERER->isHeadless())
+	{
+		io.Fonts->TexID = ImGui::User::GetImTextureID(nullptr);
+		return;
+	}
+
 	io.Fonts->TexID = ImGui::User::GetImTextureID(std::make_shared<skygfx::Texture>(width, height,
 		skygfx::PixelFormat::RGBA8UNorm, data));
 }
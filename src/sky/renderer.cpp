@@ -14,19 +14,32 @@ Renderer::Renderer(std::optional<skygfx::BackendType> type, skygfx::Adapter adap
 	skygfx::SetVsync(true);
 }
 
+Renderer::Renderer(std::shared_ptr<CommandRecorder> recorder) : mRecorder(recorder)
+{
+	assert(mRecorder != nullptr);
+}
+
 Renderer::~Renderer()
 {
+	if (isHeadless())
+		return;
+
 	skygfx::Finalize();
 }
 
 void Renderer::onEvent(const Platform::System::ResizeEvent& e)
 {
+	if (isHeadless())
+		return;
+
 	skygfx::Resize(e.width, e.height);
 }
 
 void Renderer::setRenderTarget(std::shared_ptr<skygfx::RenderTarget> value)
 {
-	if (value == nullptr)
+	if (isHeadless())
+		mRecorder->setRenderTarget(value.get());
+	else if (value == nullptr)
 		skygfx::SetRenderTarget(std::nullopt);
 	else
 		skygfx::SetRenderTarget(*value);
@@ -34,11 +47,29 @@ void Renderer::setRenderTarget(std::shared_ptr<skygfx::RenderTarget> value)
 
 void Renderer::clear(std::optional<glm::vec4> color, std::optional<float> depth, std::optional<uint8_t> stencil)
 {
-	skygfx::Clear(color, depth, stencil);
+	if (isHeadless())
+		mRecorder->clear(color, depth, stencil);
+	else
+		skygfx::Clear(color, depth, stencil);
 }
 
 void Renderer::present()
 {
+	if (isHeadless())
+	{
+		mRecorder->present();
+		mDrawcalls = mRecorder->getFrameCounters().draws;
+		return;
+	}
+
 	auto result = skygfx::Present();
 	mDrawcalls = result.drawcalls;
 }
+
+void Renderer::execute(const std::vector<skygfx::utils::Command>& cmds, uint32_t vertex_count, uint32_t index_count)
+{
+	if (isHeadless())
+		mRecorder->execute(cmds, vertex_count, index_count);
+	else
+		skygfx::utils::ExecuteCommands(cmds);
+}
@@ -5,6 +5,7 @@
 #include <skygfx/vertex.h>
 #include <skygfx/utils.h>
 #include <sky/dispatcher.h>
+#include <sky/command_recorder.h>
 #include <platform/all.h>
 
 #define RENDERER sky::Locator<sky::Renderer>::Get()
@@ -16,6 +17,7 @@ namespace sky
 	public:
 		Renderer(std::optional<skygfx::BackendType> type = std::nullopt,
 			skygfx::Adapter adapter = skygfx::Adapter::HighPerformance);
+		Renderer(std::shared_ptr<CommandRecorder> recorder); // headless, without gpu device
 		~Renderer();
 
 	private:
@@ -29,10 +31,16 @@ namespace sky
 
 		void present();
 
+		void execute(const std::vector<skygfx::utils::Command>& cmds, uint32_t vertex_count, uint32_t index_count);
+
 	public:
 		int getDrawcalls() const { return mDrawcalls; }
 
+		bool isHeadless() const { return mRecorder != nullptr; }
+		auto getRecorder() const { return mRecorder; }
+
 	private:
 		int mDrawcalls = 0;
+		std::shared_ptr<CommandRecorder> mRecorder = nullptr;
 	};
 }
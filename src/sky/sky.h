@@ -9,6 +9,7 @@
 #include <sky/cache.h>
 #include <sky/clock.h>
 #include <sky/color.h>
+#include <sky/command_recorder.h>
 #include <sky/console.h>
 #include <sky/dispatcher.h>
 #include <sky/imgui_console.h>
@@ -19,6 +20,7 @@
 #include <sky/scheduler.h>
 #include <sky/task.h>
 #include <sky/text_mesh.h>
+#include <sky/text_mesh_cache.h>
 #include <sky/time_expiring_cache.h>
 #include <sky/timer.h>
 #include <sky/updatable.h>
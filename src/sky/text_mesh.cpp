@@ -1,5 +1,5 @@
 #include "text_mesh.h"
-#include <sky/color.h>
+#include <algorithm>
 
 using namespace sky;
 
@@ -8,22 +8,6 @@ TextMesh::Symbol::Symbol(glm::vec2 pos, glm::vec2 size, float line_y) :
 {
 }
 
-static float GetStringWidth(const Graphics::Font& font, std::wstring::const_iterator begin, std::wstring::const_iterator end, float size = Graphics::Font::GlyphSize)
-{
-	float result = 0.0f;
-
-	for (auto it = begin; it != end; ++it)
-	{
-		result += font.getGlyph(*it).xadvance;
-
-		if (it != end - 1)
-		{
-			result += font.getKerning(*it, *(it + 1));
-		}
-	}
-	return result * Graphics::Font::getScaleFactorForSize(size);
-}
-
 static float GetAlignNormalizedValue(TextMesh::Align align)
 {
 	if (align == TextMesh::Align::Center)
@@ -35,149 +19,145 @@ static float GetAlignNormalizedValue(TextMesh::Align align)
 	return 0.0f;
 }
 
-struct Line
-{
-	Line(const Graphics::Font& font, std::wstring::const_iterator begin, std::wstring::const_iterator end) :
-		begin(begin),
-		end(end)
-	{
-		width = GetStringWidth(font, begin, end);
-	}
-	std::wstring::const_iterator begin;
-	std::wstring::const_iterator end;
-	float width;
-};
-
-static std::vector<Line> CreateLines(const Graphics::Font& font, const std::wstring& text, std::optional<float> maxWidth, float size)
+// single pass, line width is accumulated per symbol in the order of advances and kernings,
+// so after rewinding to last space only the carried word is laid out again
+static void CreateLines(const Graphics::Font& font, const std::wstring& text, std::optional<float> maxWidth, float size,
+	std::vector<TextMesh::Line>& result)
 {
-	std::vector<Line> result;
+	result.clear();
 
+	auto scale = Graphics::Font::getScaleFactorForSize(size);
 	auto begin = text.begin();
 	auto end = text.end();
 	auto it = begin;
 
+	float width = 0.0f; // of [begin, it)
+	std::optional<std::wstring::const_iterator> break_it; // after last space, space at line begin is not a break
+	float break_width = 0.0f; // of [begin, break_it)
+
+	auto push_line = [&](std::wstring::const_iterator line_end, float line_width) {
+		result.push_back({ static_cast<size_t>(begin - text.begin()), static_cast<size_t>(line_end - text.begin()), line_width });
+		begin = line_end;
+		width = 0.0f;
+		break_it.reset();
+	};
+
 	while (it != end)
 	{
 		if (*it == '\n')
 		{
-			result.push_back(Line(font, begin, it));
+			push_line(it, width);
 			++it;
 			begin = it;
 			continue;
 		}
 
-		++it;
+		auto prev_width = width;
 
-		if (!maxWidth.has_value())
-			continue;
+		if (it != begin)
+			width += font.getKerning(*(it - 1), *it);
 
-		auto length = std::distance(begin, it);
+		width += font.getGlyph(*it).xadvance;
 
-		if (length <= 1)
-			continue;
+		if (*it == ' ' && it != begin)
+		{
+			break_it = it + 1;
+			break_width = width;
+		}
 
-		auto str_w = GetStringWidth(font, begin, it, size);
+		++it;
 
-		if (str_w <= maxWidth.value())
+		if (!maxWidth.has_value())
 			continue;
 
-		--it;
+		if (std::distance(begin, it) <= 1)
+			continue;
 
-		auto best_it = it;
+		if (width * scale <= maxWidth.value())
+			continue;
 
-		while (best_it != begin)
+		if (break_it.has_value())
 		{
-			if (*best_it == ' ')
-			{
-				++best_it;
-				break;
-			}
-
-			--best_it;
+			it = break_it.value();
+			push_line(it, break_width);
+		}
+		else
+		{
+			--it;
+			push_line(it, prev_width);
 		}
-
-		if (best_it != begin)
-			it = best_it;
-
-		result.push_back(Line(font, begin, it));
-		begin = it;
 	}
 
-	result.push_back(Line(font, begin, end));
-
-	return result;
+	result.push_back({ static_cast<size_t>(begin - text.begin()), text.size(), width });
 }
 
 TextMesh::TextMesh(const Graphics::Font& font, const std::wstring& text, std::optional<float> maxWidth, float fontSize, Align align)
 {
-	mTopology = skygfx::Topology::TriangleList;
+	rebuild(font, text, maxWidth, fontSize, align);
+}
 
-	auto lines = CreateLines(font, text, maxWidth, fontSize);
+void TextMesh::rebuild(const Graphics::Font& font, const std::wstring& text, std::optional<float> maxWidth, float fontSize, Align align)
+{
+	CreateLines(font, text, maxWidth, fontSize, mLines);
 
-	const auto texture = font.getTexture();
-	glm::vec2 tex_size = { static_cast<float>(texture->getWidth()), static_cast<float>(texture->getHeight()) };
+	mGlyphs.clear();
+	mSymbols.clear();
+	mPages.clear();
+	mSize = { 0.0f, 0.0f };
 
 	size_t length = 0;
 
-	for (const auto& line : lines)
+	for (const auto& line : mLines)
 	{
-		length += std::distance(line.begin, line.end);
+		length += line.end - line.begin;
 		mSize.x = glm::max(mSize.x, line.width);
 	}
 
 	if (maxWidth.has_value())
 		mSize.x = glm::max(mSize.x, maxWidth.value() / font.getScaleFactorForSize(fontSize));
 
-	mVertices.resize(length * 4);
-	mIndices.resize(length * 6);
+	mGlyphs.reserve(length);
+	mSymbols.reserve(length);
 
-	int i = 0;
+	const auto white = glm::u8vec4{ 255, 255, 255, 255 };
 
-	for (const auto& line : lines)
+	for (const auto& line : mLines)
 	{
 		float pos_x = (mSize.x - line.width) * GetAlignNormalizedValue(align);
+		auto line_begin = text.begin() + line.begin;
+		auto line_end = text.begin() + line.end;
 
-		for (auto it = line.begin; it != line.end; ++it, i++)
+		for (auto it = line_begin; it != line_end; ++it)
 		{
 			const auto& glyph = font.getGlyph(*it);
 
-			auto vtx = &mVertices[i * 4];
-			auto idx = &mIndices[i * 6];
-
-			pos_x += glyph.offset.x;
-			float pos_y = mSize.y + font.getAscent() + glyph.offset.y;
+			auto pos = glm::vec2{ pos_x, mSize.y + font.getAscent() } + glyph.offset;
 
-			glm::vec2 p1 = { pos_x, pos_y };
-			glm::vec2 p2 = glm::vec2{ pos_x, pos_y } + glyph.size;
-
-			pos_x -= glyph.offset.x;
 			pos_x += glyph.xadvance;
 
-			if (it != line.end - 1)
+			if (it != line_end - 1)
 			{
 				pos_x += font.getKerning(*it, *(it + 1));
 			}
 
-			auto uv1 = glyph.pos / tex_size;
-			auto uv2 = (glyph.pos + glyph.size) / tex_size;
-
-			auto color = sky::GetColor<glm::vec4>(sky::Color::White);
-
-			vtx[0] = { { p1.x, p1.y, 0.0f }, color, { uv1.x, uv1.y } };
-			vtx[1] = { { p1.x, p2.y, 0.0f }, color, { uv1.x, uv2.y } };
-			vtx[2] = { { p2.x, p2.y, 0.0f }, color, { uv2.x, uv2.y } };
-			vtx[3] = { { p2.x, p1.y, 0.0f }, color, { uv2.x, uv1.y } };
+			mGlyphs.push_back(GlyphInstance{
+				.pos = pos,
+				.atlas_pos = glm::u16vec2(glyph.pos),
+				.atlas_size = glm::u16vec2(glyph.size),
+				.color = white,
+				.page = glyph.page
+			});
 
-			auto base_vtx = i * 4;
+			mSymbols.push_back(TextMesh::Symbol(pos, glyph.size, mSize.y));
 
-			idx[0] = base_vtx + 0;
-			idx[1] = base_vtx + 1;
-			idx[2] = base_vtx + 2;
-			idx[3] = base_vtx + 0;
-			idx[4] = base_vtx + 2;
-			idx[5] = base_vtx + 3;
-
-			mSymbols.push_back(TextMesh::Symbol(p1, glyph.size, mSize.y));
+			if (mPages.empty() || mPages.back() != glyph.page)
+			{
+				if (auto page_it = std::lower_bound(mPages.begin(), mPages.end(), glyph.page);
+					page_it == mPages.end() || *page_it != glyph.page)
+				{
+					mPages.insert(page_it, glyph.page);
+				}
+			}
 		}
 
 		mSize.y += font.getAscent() - font.getDescent() + font.getLinegap();
@@ -189,10 +169,36 @@ TextMesh::TextMesh(const Graphics::Font& font, const std::wstring& text, std::op
 
 void TextMesh::setSymbolColor(size_t index, const glm::vec4& color)
 {
-	size_t base_vtx = index * 4;
+	mGlyphs[index].color = glm::u8vec4(glm::round(glm::clamp(color, 0.0f, 1.0f) * 255.0f));
+}
+
+void TextMesh::AppendQuads(const GlyphInstance* glyphs, size_t count, uint32_t page,
+	Vertices& vertices, Indices& indices)
+{
+	const auto tex_size = glm::vec2{ static_cast<float>(Graphics::Font::PageSize) };
 
-	for (size_t i = base_vtx; i < base_vtx + 4; i++)
+	for (size_t i = 0; i < count; i++)
 	{
-		mVertices[i].color = color;
+		const auto& glyph = glyphs[i];
+
+		if (glyph.page != page)
+			continue;
+
+		auto p1 = glyph.pos;
+		auto p2 = glyph.pos + glm::vec2(glyph.atlas_size);
+		auto uv1 = glm::vec2(glyph.atlas_pos) / tex_size;
+		auto uv2 = glm::vec2(glyph.atlas_pos + glyph.atlas_size) / tex_size;
+		auto color = glm::vec4(glyph.color) / 255.0f;
+		auto base_vtx = static_cast<uint32_t>(vertices.size());
+
+		vertices.push_back({ { p1.x, p1.y, 0.0f }, color, { uv1.x, uv1.y } });
+		vertices.push_back({ { p1.x, p2.y, 0.0f }, color, { uv1.x, uv2.y } });
+		vertices.push_back({ { p2.x, p2.y, 0.0f }, color, { uv2.x, uv2.y } });
+		vertices.push_back({ { p2.x, p1.y, 0.0f }, color, { uv2.x, uv1.y } });
+
+		indices.insert(indices.end(), {
+			base_vtx + 0, base_vtx + 1, base_vtx + 2,
+			base_vtx + 0, base_vtx + 2, base_vtx + 3
+		});
 	}
 }
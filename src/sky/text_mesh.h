@@ -24,25 +24,53 @@ namespace sky
 			float line_y;
 		};
 
+		// compact quad of one symbol, expanded into vertices only when drawn,
+		// quad size equals atlas rect size because glyphs are rasterized at one scale
+		struct GlyphInstance
+		{
+			glm::vec2 pos; // top left, unscaled
+			glm::u16vec2 atlas_pos; // in texels of font page
+			glm::u16vec2 atlas_size;
+			glm::u8vec4 color;
+			uint32_t page;
+		};
+
+		struct Line
+		{
+			size_t begin; // offsets of symbols in text
+			size_t end;
+			float width; // unscaled
+		};
+
 		using Symbols = std::vector<Symbol>;
+		using Glyphs = std::vector<GlyphInstance>;
 		using Vertices = skygfx::utils::Mesh::Vertices;
 		using Indices = skygfx::utils::Mesh::Indices;
 
+		static constexpr auto Topology = skygfx::Topology::TriangleList;
+
+		// appends triangle list quads of glyphs from given page
+		static void AppendQuads(const GlyphInstance* glyphs, size_t count, uint32_t page,
+			Vertices& vertices, Indices& indices);
+
 		TextMesh(const Graphics::Font& font, const std::wstring& text, std::optional<float> maxWidth, float fontSize, Align align);
 
+		// lays out text again into existing buffers, allocates only when text outgrows them
+		void rebuild(const Graphics::Font& font, const std::wstring& text, std::optional<float> maxWidth, float fontSize, Align align);
+
 		void setSymbolColor(size_t index, const glm::vec4& color);
 
-		auto getTopology() const { return mTopology; }
-		const auto& getVertices() const { return mVertices; }
-		const auto& getIndices() const { return mIndices; }
+		const auto& getGlyphs() const { return mGlyphs; }
 		const auto& getSymbols() const { return mSymbols; }
+		const auto& getPages() const { return mPages; } // sorted font pages used by glyphs
+		const auto& getLines() const { return mLines; }
 		const auto& getSize() const { return mSize; }
 
 	private:
-		skygfx::Topology mTopology;
-		Indices mIndices;
-		Vertices mVertices;
+		Glyphs mGlyphs;
 		Symbols mSymbols;
+		std::vector<uint32_t> mPages;
+		std::vector<Line> mLines;
 		glm::vec2 mSize = { 0.0f, 0.0f };
 	};
 }
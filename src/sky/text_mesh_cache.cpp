@@ -0,0 +1,121 @@
+#include "text_mesh_cache.h"
+#include <common/hash.h>
+
+using namespace sky;
+
+size_t TextMeshCache::KeyHash::operator()(const Key& key) const
+{
+	size_t seed = 0;
+	Common::Hash::combine(seed, key.font);
+	Common::Hash::combine(seed, key.text);
+	Common::Hash::combine(seed, key.font_size);
+	Common::Hash::combine(seed, key.max_width);
+	Common::Hash::combine(seed, key.align);
+	return seed;
+}
+
+std::shared_ptr<const TextMesh> TextMeshCache::get(const std::shared_ptr<Graphics::Font>& font,
+	const std::wstring& text, std::optional<float> maxWidth, float fontSize, TextMesh::Align align)
+{
+	auto key = Key{
+		.font = font.get(),
+		.text = text,
+		.font_size = fontSize,
+		.max_width = maxWidth,
+		.align = align
+	};
+
+	{
+		std::lock_guard lock(mMutex);
+
+		if (auto it = mIndex.find(key); it != mIndex.end())
+		{
+			auto entry = it->second;
+
+			if (entry->font.lock() == font)
+			{
+				mEntries.splice(mEntries.begin(), mEntries, entry);
+				mHits++;
+				return entry->mesh;
+			}
+
+			mMemoryUsage -= entry->size;
+			mEntries.erase(entry);
+			mIndex.erase(it);
+		}
+	}
+
+	// built without lock, concurrent misses of same key build it twice and first insert wins
+	mMisses++;
+	auto mesh = std::make_shared<const TextMesh>(*font, text, maxWidth, fontSize, align);
+
+	std::lock_guard lock(mMutex);
+
+	if (auto it = mIndex.find(key); it != mIndex.end())
+		return it->second->mesh;
+
+	auto& entry = mEntries.emplace_front(Entry{
+		.key = key,
+		.font = font,
+		.mesh = mesh,
+		.size = 0
+	});
+
+	entry.size = GetSize(entry);
+	mMemoryUsage += entry.size;
+	mIndex.insert({ std::move(key), mEntries.begin() });
+
+	trim();
+
+	return mesh;
+}
+
+void TextMeshCache::clear()
+{
+	std::lock_guard lock(mMutex);
+	mIndex.clear();
+	mEntries.clear();
+	mMemoryUsage = 0;
+}
+
+void TextMeshCache::setBudget(size_t value)
+{
+	std::lock_guard lock(mMutex);
+	mBudget = value;
+	trim();
+}
+
+size_t TextMeshCache::getMemoryUsage() const
+{
+	std::lock_guard lock(mMutex);
+	return mMemoryUsage;
+}
+
+size_t TextMeshCache::getEntriesCount() const
+{
+	std::lock_guard lock(mMutex);
+	return mEntries.size();
+}
+
+void TextMeshCache::trim()
+{
+	// most recent entry stays even if it alone exceeds budget
+	while (mMemoryUsage > mBudget && mEntries.size() > 1)
+	{
+		const auto& entry = mEntries.back();
+		mMemoryUsage -= entry.size;
+		mIndex.erase(entry.key);
+		mEntries.pop_back();
+	}
+}
+
+size_t TextMeshCache::GetSize(const Entry& entry)
+{
+	const auto& mesh = *entry.mesh;
+
+	return sizeof(Entry) + (entry.key.text.size() * sizeof(wchar_t) * 2) +
+		(mesh.getGlyphs().size() * sizeof(TextMesh::GlyphInstance)) +
+		(mesh.getSymbols().size() * sizeof(TextMesh::Symbol)) +
+		(mesh.getPages().size() * sizeof(uint32_t)) +
+		(mesh.getLines().size() * sizeof(TextMesh::Line));
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <sky/text_mesh.h>
+#include <sky/locator.h>
+#include <graphics/font.h>
+#include <atomic>
+#include <unordered_map>
+#include <optional>
+#include <memory>
+#include <string>
+#include <mutex>
+#include <list>
+
+#define TEXT_MESH_CACHE sky::Locator<sky::TextMeshCache>::Get()
+
+namespace sky
+{
+	// shared layouts of equal texts, meshes are immutable and evicted in lru order
+	// when memory budget is exceeded. thread safe, labels refresh from isolated updates
+
+	class TextMeshCache
+	{
+	public:
+		std::shared_ptr<const TextMesh> get(const std::shared_ptr<Graphics::Font>& font, const std::wstring& text,
+			std::optional<float> maxWidth, float fontSize, TextMesh::Align align);
+
+		void clear();
+
+	public:
+		auto getBudget() const { return mBudget; }
+		void setBudget(size_t value);
+
+		size_t getMemoryUsage() const;
+		size_t getEntriesCount() const;
+		uint64_t getHits() const { return mHits; }
+		uint64_t getMisses() const { return mMisses; }
+
+	private:
+		struct Key
+		{
+			const Graphics::Font* font;
+			std::wstring text;
+			float font_size;
+			std::optional<float> max_width;
+			TextMesh::Align align;
+
+			bool operator==(const Key& other) const = default;
+		};
+
+		struct KeyHash
+		{
+			size_t operator()(const Key& key) const;
+		};
+
+		struct Entry
+		{
+			Key key;
+			std::weak_ptr<Graphics::Font> font; // address of destroyed font can be reused
+			std::shared_ptr<const TextMesh> mesh;
+			size_t size;
+		};
+
+		using Entries = std::list<Entry>; // most recently used first
+
+		void trim();
+		static size_t GetSize(const Entry& entry);
+
+	private:
+		mutable std::mutex mMutex;
+		Entries mEntries;
+		std::unordered_map<Key, Entries::iterator, KeyHash> mIndex;
+		size_t mBudget = 4 * 1024 * 1024;
+		size_t mMemoryUsage = 0;
+		std::atomic<uint64_t> mHits = 0;
+		std::atomic<uint64_t> mMisses = 0;
+	};
+}
@@ -2,7 +2,6 @@
 #include <sky/cache.h>
 #include <sky/localization.h>
 #include <codecvt>
-#include <regex>
 #ifdef EMSCRIPTEN
 #include <emscripten.h>
 #endif
@@ -54,24 +53,46 @@ std::wstring sky::Localize(const std::string& key)
 
 std::wstring sky::UnfoldLocaleTags(const std::wstring& str)
 {
-	std::wregex pattern(LR"(<loc=([^>]+)>)");
-	std::wstring result;
-	std::wsregex_iterator it(str.begin(), str.end(), pattern);
-	std::wsregex_iterator end;
-	size_t last_pos = 0;
-	for (; it != end; ++it) {
-		const auto& match = *it;
-		auto start = match.position();
-		auto length = match.length();
-		auto key = match[1].str();
-		result += str.substr(last_pos, start - last_pos);
-		result += Localize(sky::to_string(key));
-		last_pos = start + length;
-	}
-	result += str.substr(last_pos);
+	// replaces <loc=key> tags, localized strings can contain tags too,
+	// so passes repeat until nothing is replaced (limited against cyclic keys)
+
+	constexpr std::wstring_view OpenTag = L"<loc=";
+	constexpr int MaxPasses = 16;
+
+	auto result = str;
+
+	for (int pass = 0; pass < MaxPasses; pass++)
+	{
+		std::wstring unfolded;
+		size_t last_pos = 0;
+		size_t pos = 0;
 
-	if (std::regex_search(result, pattern))
-		return UnfoldLocaleTags(result);
+		while ((pos = result.find(OpenTag, pos)) != std::wstring::npos)
+		{
+			auto key_pos = pos + OpenTag.size();
+			auto close_pos = result.find(L'>', key_pos);
+
+			if (close_pos == std::wstring::npos)
+				break;
+
+			if (close_pos == key_pos)
+			{
+				pos += 1;
+				continue;
+			}
+
+			unfolded.append(result, last_pos, pos - last_pos);
+			unfolded += Localize(sky::to_string(result.substr(key_pos, close_pos - key_pos)));
+			last_pos = close_pos + 1;
+			pos = last_pos;
+		}
+
+		if (last_pos == 0)
+			break;
+
+		unfolded.append(result, last_pos);
+		result = std::move(unfolded);
+	}
 
 	return result;
 }